@@ -0,0 +1,453 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include "quadtree.h"
+#include "simd_kernels.h"
+
+using namespace std;
+
+// Micro-benchmark fungsi error, pembangunan pohon, penggambaran dan pencarian threshold pada
+// gambar sintetis. Hasil ditulis sebagai JSON satu baris per benchmark dengan urutan field
+// tetap agar hasil dua build bisa dibandingkan dengan diff.
+
+// Threshold pembangunan pohon per metode (indeks 1-5), kira-kira di tengah rentang yang wajar
+static const double BUILD_THRESHOLDS[6] = {0, 50, 5, 20, 3, 500};
+static const char* METHOD_NAMES[6] = {"", "variance", "mad", "maxdiff", "entropy", "ssim"};
+
+struct BenchmarkOptions {
+    vector<int> sizes = {512, 1024, 2048};
+    vector<string> images = {"flat", "gradient", "noise", "natural", "natural-gray"};
+    vector<int> blockSizes = {8, 32, 128};
+    vector<int> minBlockSizes = {1, 4, 16};
+    int samples = 5;
+    double minSampleMs = 20;
+    string filter;
+    string outputPath;
+};
+
+struct BenchmarkResult {
+    string name;
+    string image;
+    int width, height;
+    int block;                  // Ukuran blok (fungsi error) atau ukuran blok minimum (pohon)
+    int method;                 // 0 jika tidak relevan
+    unsigned long long pixels;  // Pixel yang diproses satu iterasi
+    int iterations;             // Iterasi per sampel
+    double nsPerPixel;          // Median seluruh sampel
+    double bestNsPerPixel;      // Sampel tercepat
+    double megapixelsPerSecond; // Dari median
+    double checksum;            // Hasil fungsi, mencegah pemanggilan dihapus compiler
+};
+
+// ===== Gambar sintetis =====
+
+static unsigned int nextRandom(unsigned int& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Value noise: nilai acak di titik kisi berjarak cellSize lalu diinterpolasi halus
+static void addValueNoise(vector<float>& field, int width, int height, int cellSize, float amplitude, unsigned int seed) {
+    int gridWidth = width / cellSize + 2;
+    int gridHeight = height / cellSize + 2;
+    vector<float> lattice(static_cast<size_t>(gridWidth) * gridHeight);
+    for (float& value : lattice) {
+        value = (nextRandom(seed) & 0xFFFF) / 65535.0f - 0.5f;
+    }
+    
+    for (int j = 0; j < height; j++) {
+        int gy = j / cellSize;
+        float ty = static_cast<float>(j % cellSize) / cellSize;
+        ty = ty * ty * (3 - 2 * ty);
+        
+        for (int i = 0; i < width; i++) {
+            int gx = i / cellSize;
+            float tx = static_cast<float>(i % cellSize) / cellSize;
+            tx = tx * tx * (3 - 2 * tx);
+            
+            const float* top = &lattice[static_cast<size_t>(gy) * gridWidth + gx];
+            const float* bottom = top + gridWidth;
+            float upper = top[0] + (top[1] - top[0]) * tx;
+            float lower = bottom[0] + (bottom[1] - bottom[0]) * tx;
+            field[static_cast<size_t>(j) * width + i] += amplitude * (upper + (lower - upper) * ty);
+        }
+    }
+}
+
+static BYTE clampToByte(float value) {
+    return static_cast<BYTE>(std::min(255.0f, std::max(0.0f, value + 0.5f)));
+}
+
+// Fungsi untuk membuat gambar sintetis: flat, gradient, noise, natural (noise halus beberapa
+// oktaf dengan tepi tajam dan sedikit noise sensor, mirip foto) atau natural-gray (channel R
+// gambar natural sebagai ImageView grayscale satu channel)
+static bool createSyntheticImage(const string& kind, int size, ImageView& image) {
+    image = createImageView(size, size);
+    size_t pixelCount = static_cast<size_t>(size) * size;
+    unsigned int seed = 0x9E3779B9u ^ static_cast<unsigned int>(size);
+    
+    if (kind == "flat") {
+        const BYTE color[3] = {120, 160, 200};
+        for (int c = 0; c < 3; c++) {
+            fill(image.planes[c].begin(), image.planes[c].end(), color[c]);
+        }
+    } else if (kind == "gradient") {
+        for (int j = 0; j < size; j++) {
+            for (int i = 0; i < size; i++) {
+                size_t index = static_cast<size_t>(j) * size + i;
+                image.planes[0][index] = static_cast<BYTE>(i * 255 / std::max(1, size - 1));
+                image.planes[1][index] = static_cast<BYTE>(j * 255 / std::max(1, size - 1));
+                image.planes[2][index] = static_cast<BYTE>((i + j) * 255 / std::max(1, 2 * size - 2));
+            }
+        }
+    } else if (kind == "noise") {
+        for (int c = 0; c < 3; c++) {
+            for (size_t index = 0; index < pixelCount; index++) {
+                image.planes[c][index] = static_cast<BYTE>(nextRandom(seed) >> 24);
+            }
+        }
+    } else if (kind == "natural") {
+        for (int c = 0; c < 3; c++) {
+            vector<float> field(pixelCount, 128.0f);
+            addValueNoise(field, size, size, std::max(2, size / 4), 160.0f, seed + 11 * c);
+            addValueNoise(field, size, size, std::max(2, size / 16), 70.0f, seed + 23 * c);
+            addValueNoise(field, size, size, std::max(2, size / 64), 30.0f, seed + 37 * c);
+            
+            // Objek dengan tepi tajam: lingkaran berwarna tetap
+            for (int k = 0; k < 6; k++) {
+                int cx = static_cast<int>(nextRandom(seed) % size);
+                int cy = static_cast<int>(nextRandom(seed) % size);
+                int radius = size / 16 + static_cast<int>(nextRandom(seed) % std::max(1, size / 8));
+                float shade = static_cast<float>(nextRandom(seed) % 256);
+                for (int j = std::max(0, cy - radius); j < std::min(size, cy + radius); j++) {
+                    for (int i = std::max(0, cx - radius); i < std::min(size, cx + radius); i++) {
+                        if ((i - cx) * (i - cx) + (j - cy) * (j - cy) < radius * radius) {
+                            field[static_cast<size_t>(j) * size + i] = shade;
+                        }
+                    }
+                }
+            }
+            
+            for (size_t index = 0; index < pixelCount; index++) {
+                float grain = static_cast<float>(nextRandom(seed) >> 28) - 7.5f;
+                image.planes[c][index] = clampToByte(field[index] + grain);
+            }
+        }
+    } else if (kind == "natural-gray") {
+        ImageView color;
+        createSyntheticImage("natural", size, color);
+        image = createImageView(size, size, 1);
+        image.planes[0].swap(color.planes[0]);
+    } else {
+        return false;
+    }
+    
+    return true;
+}
+
+// ===== Pengukuran =====
+
+// Fungsi untuk mengukur body: satu pemanggilan pemanasan untuk kalibrasi, lalu beberapa sampel
+// yang masing-masing berisi cukup iterasi agar berjalan minimal minSampleMs
+static void measure(const BenchmarkOptions& options, unsigned long long pixels,
+                    const function<double()>& body, BenchmarkResult& result) {
+    typedef chrono::steady_clock Clock;
+    
+    auto warmStart = Clock::now();
+    double checksum = body();
+    double warmNs = chrono::duration<double, nano>(Clock::now() - warmStart).count();
+    
+    int iterations = static_cast<int>(options.minSampleMs * 1e6 / std::max(warmNs, 1.0));
+    iterations = std::max(1, std::min(iterations, 1000000));
+    
+    vector<double> nsPerPixel;
+    for (int sample = 0; sample < options.samples; sample++) {
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; i++) {
+            checksum = body();
+        }
+        double ns = chrono::duration<double, nano>(Clock::now() - start).count();
+        nsPerPixel.push_back(ns / (static_cast<double>(pixels) * iterations));
+    }
+    sort(nsPerPixel.begin(), nsPerPixel.end());
+    
+    result.pixels = pixels;
+    result.iterations = iterations;
+    result.nsPerPixel = nsPerPixel[nsPerPixel.size() / 2];
+    result.bestNsPerPixel = nsPerPixel[0];
+    result.megapixelsPerSecond = 1e3 / result.nsPerPixel;
+    result.checksum = checksum;
+}
+
+// Fungsi untuk menjumlahkan hasil fungsi error di seluruh blok berukuran block x block
+template <typename Metric>
+static double sumOverBlocks(const ImageView& image, int block, Metric metric) {
+    double total = 0;
+    for (int y = 0; y < image.height; y += block) {
+        int height = std::min(block, image.height - y);
+        for (int x = 0; x < image.width; x += block) {
+            total += metric(x, y, std::min(block, image.width - x), height);
+        }
+    }
+    return total;
+}
+
+static void writeResult(ostream& output, const BenchmarkResult& result) {
+    char numbers[160];
+    snprintf(numbers, sizeof(numbers),
+             "\"nsPerPixel\": %.4f, \"bestNsPerPixel\": %.4f, \"megapixelsPerSecond\": %.2f, \"checksum\": %.10g",
+             result.nsPerPixel, result.bestNsPerPixel, result.megapixelsPerSecond, result.checksum);
+    
+    output << "{\"name\": \"" << result.name << "\", \"image\": \"" << result.image
+           << "\", \"width\": " << result.width << ", \"height\": " << result.height
+           << ", \"block\": " << result.block << ", \"method\": " << result.method
+           << ", \"pixels\": " << result.pixels << ", \"iterations\": " << result.iterations
+           << ", " << numbers << "}";
+}
+
+// ===== Daftar benchmark =====
+
+struct BenchmarkRunner {
+    const BenchmarkOptions& options;
+    vector<BenchmarkResult> results;
+    
+    explicit BenchmarkRunner(const BenchmarkOptions& options) : options(options) {}
+    
+    // Menjalankan satu benchmark jika namanya lolos filter
+    void run(const string& name, const string& image, const ImageView& view, int block, int method,
+             unsigned long long pixels, const function<double()>& body) {
+        string label = name + "/" + image + "/" + to_string(view.width) + "/" + to_string(block);
+        if (method > 0) label += string("/") + METHOD_NAMES[method];
+        if (!options.filter.empty() && label.find(options.filter) == string::npos) return;
+        
+        cerr << label << "..." << flush;
+        
+        BenchmarkResult result;
+        result.name = name;
+        result.image = image;
+        result.width = view.width;
+        result.height = view.height;
+        result.block = block;
+        result.method = method;
+        measure(options, pixels, body, result);
+        results.push_back(result);
+        
+        cerr << " " << result.nsPerPixel << " ns/pixel" << endl;
+    }
+};
+
+static void runImageBenchmarks(BenchmarkRunner& runner, const string& kind, const ImageView& image) {
+    const BenchmarkOptions& options = runner.options;
+    unsigned long long pixels = static_cast<unsigned long long>(image.width) * image.height;
+    
+    IntegralImage integral;
+    runner.run("buildIntegralImage", kind, image, 0, 0, pixels, [&] {
+        integral = buildIntegralImage(image);
+        return static_cast<double>(integral.sumR.back());
+    });
+    if (integral.sumR.empty()) {
+        integral = buildIntegralImage(image);
+    }
+    
+    // Fungsi error per blok. Warna rata-rata dihitung sekali di luar pengukuran karena pada
+    // pembangunan pohon nilainya sudah tersedia dari integral image.
+    for (int block : options.blockSizes) {
+        if (block > image.width) continue;
+        
+        vector<RGBQUAD> averages;
+        sumOverBlocks(image, block, [&](int x, int y, int width, int height) {
+            averages.push_back(calculateAverageColor(integral, x, y, width, height));
+            return 0.0;
+        });
+        
+        auto withAverage = [&](double (*metric)(const ImageView&, int, int, int, int, RGBQUAD)) {
+            return [&, metric] {
+                size_t index = 0;
+                return sumOverBlocks(image, block, [&](int x, int y, int width, int height) {
+                    return metric(image, x, y, width, height, averages[index++]);
+                });
+            };
+        };
+        auto withIntegral = [&](double (*metric)(const IntegralImage&, int, int, int, int, RGBQUAD)) {
+            return [&, metric] {
+                size_t index = 0;
+                return sumOverBlocks(image, block, [&](int x, int y, int width, int height) {
+                    return metric(integral, x, y, width, height, averages[index++]);
+                });
+            };
+        };
+        
+        runner.run("calculateVariance", kind, image, block, 1, pixels, withAverage(calculateVariance));
+        runner.run("calculateVariance/integral", kind, image, block, 1, pixels, withIntegral(calculateVariance));
+        runner.run("calculateMAD", kind, image, block, 2, pixels, withAverage(calculateMAD));
+        runner.run("calculateMaxDifference", kind, image, block, 3, pixels, [&] {
+            return sumOverBlocks(image, block, [&](int x, int y, int width, int height) {
+                return calculateMaxDifference(image, x, y, width, height);
+            });
+        });
+        runner.run("calculateEntropy", kind, image, block, 4, pixels, [&] {
+            return sumOverBlocks(image, block, [&](int x, int y, int width, int height) {
+                return calculateEntropy(image, x, y, width, height);
+            });
+        });
+        runner.run("calculateSSIM", kind, image, block, 5, pixels, withAverage(calculateSSIM));
+        runner.run("calculateSSIM/integral", kind, image, block, 5, pixels, withIntegral(calculateSSIM));
+    }
+    
+    // Pembangunan pohon serial untuk setiap metode dan ukuran blok minimum
+    for (int minBlockSize : options.minBlockSizes) {
+        for (int method = 1; method <= 5; method++) {
+            runner.run("buildQuadTree", kind, image, minBlockSize, method, pixels, [&] {
+                QuadTree tree = buildQuadTree(image, integral, 0, 0, image.width, image.height,
+                                              minBlockSize, BUILD_THRESHOLDS[method], method);
+                return static_cast<double>(tree.nodes.size());
+            });
+        }
+    }
+    
+    // Penggambaran dan pencarian threshold memakai pohon Variance dengan blok minimum 4
+    QuadTree tree = buildQuadTree(image, integral, 0, 0, image.width, image.height, 4, BUILD_THRESHOLDS[1], 1);
+    ImageView output = createImageView(image.width, image.height);
+    runner.run("drawQuadTree", kind, image, 4, 1, pixels, [&] {
+        drawQuadTree(output, tree);
+        return static_cast<double>(output.planes[0][0]);
+    });
+    
+    runner.run("findThresholdForTargetCompression", kind, image, 4, 1, pixels, [&] {
+        return findThresholdForTargetCompression(image, 4, 1, 50.0);
+    });
+}
+
+// ===== Argumen =====
+
+static bool parseList(const string& text, vector<int>& values) {
+    values.clear();
+    stringstream stream(text);
+    string item;
+    while (getline(stream, item, ',')) {
+        char* end = nullptr;
+        long value = strtol(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0' || value <= 0) return false;
+        values.push_back(static_cast<int>(value));
+    }
+    return !values.empty();
+}
+
+static void printUsage(const char* program) {
+    cerr << "Penggunaan: " << program << " [opsi]\n"
+         << "  --sizes N,N,...        sisi gambar sintetis (default 512,1024,2048)\n"
+         << "  --full                 sisi 512 hingga 8192 (butuh memori sekitar 4 GB)\n"
+         << "  --images A,B,...       flat, gradient, noise, natural, natural-gray\n"
+         << "                         (default semua)\n"
+         << "  --blocks N,N,...       ukuran blok fungsi error (default 8,32,128)\n"
+         << "  --min-blocks N,N,...   ukuran blok minimum pembangunan pohon (default 1,4,16)\n"
+         << "  --samples N            jumlah sampel per benchmark (default 5)\n"
+         << "  --min-time MS          durasi minimum satu sampel (default 20)\n"
+         << "  --filter TEKS          hanya jalankan benchmark yang labelnya memuat TEKS\n"
+         << "  --simd scalar|sse2|avx2  paksa tingkat instruksi SIMD\n"
+         << "  --output PATH          tulis JSON ke file (default stdout)\n";
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    
+    for (int i = 1; i < argc; i++) {
+        string flag = argv[i];
+        if (flag == "-h" || flag == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (flag == "--full") {
+            options.sizes = {512, 1024, 2048, 4096, 8192};
+            continue;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Flag " << flag << " membutuhkan nilai" << endl;
+            return 2;
+        }
+        
+        string value = argv[++i];
+        bool valid = true;
+        if (flag == "--sizes") {
+            valid = parseList(value, options.sizes);
+        } else if (flag == "--blocks") {
+            valid = parseList(value, options.blockSizes);
+        } else if (flag == "--min-blocks") {
+            valid = parseList(value, options.minBlockSizes);
+        } else if (flag == "--images") {
+            options.images.clear();
+            stringstream stream(value);
+            string item;
+            while (getline(stream, item, ',')) options.images.push_back(item);
+        } else if (flag == "--samples") {
+            options.samples = atoi(value.c_str());
+            valid = options.samples > 0;
+        } else if (flag == "--min-time") {
+            options.minSampleMs = atof(value.c_str());
+            valid = options.minSampleMs > 0;
+        } else if (flag == "--filter") {
+            options.filter = value;
+        } else if (flag == "--output") {
+            options.outputPath = value;
+        } else if (flag == "--simd") {
+            if (value == "scalar") setSimdLevel(SIMD_SCALAR);
+            else if (value == "sse2") setSimdLevel(SIMD_SSE2);
+            else if (value == "avx2") setSimdLevel(SIMD_AVX2);
+            else valid = false;
+        } else {
+            valid = false;
+        }
+        
+        if (!valid) {
+            cerr << "Flag atau nilai tidak valid: " << flag << " " << value << endl;
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    
+    BenchmarkRunner runner(options);
+    for (int size : options.sizes) {
+        for (const string& kind : options.images) {
+            ImageView image;
+            if (!createSyntheticImage(kind, size, image)) {
+                cerr << "Jenis gambar tidak dikenal: " << kind << endl;
+                return 2;
+            }
+            runImageBenchmarks(runner, kind, image);
+        }
+    }
+    
+    ofstream file;
+    if (!options.outputPath.empty()) {
+        file.open(options.outputPath.c_str());
+        if (!file) {
+            cerr << "Gagal membuka " << options.outputPath << endl;
+            return 1;
+        }
+    }
+    ostream& output = options.outputPath.empty() ? cout : file;
+    
+    output << "{\n";
+    output << "  \"format\": \"quadtree-benchmark\",\n";
+    output << "  \"version\": 1,\n";
+    output << "  \"simd\": \"" << getSimdLevelName(getSimdLevel()) << "\",\n";
+    output << "  \"results\": [";
+    for (size_t i = 0; i < runner.results.size(); i++) {
+        output << (i ? ",\n    " : "\n    ");
+        writeResult(output, runner.results[i]);
+    }
+    output << (runner.results.empty() ? "]\n" : "\n  ]\n");
+    output << "}\n";
+    
+    return output ? 0 : 1;
+}
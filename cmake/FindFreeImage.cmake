@@ -0,0 +1,31 @@
+# Mencari library FreeImage dan membuat target FreeImage::FreeImage
+#
+# Library sistem (misalnya libfreeimage-dev di Linux) diutamakan. Jika tidak ada, dipakai
+# FreeImage.h dan FreeImage.lib yang disertakan di lib/FreeImage (Windows).
+#
+# Variabel hasil: FreeImage_FOUND, FreeImage_INCLUDE_DIR, FreeImage_LIBRARY
+
+find_path(FreeImage_INCLUDE_DIR
+    NAMES FreeImage.h
+    PATHS "${PROJECT_SOURCE_DIR}/lib/FreeImage"
+)
+
+find_library(FreeImage_LIBRARY
+    NAMES freeimage FreeImage
+    PATHS "${PROJECT_SOURCE_DIR}/lib/FreeImage"
+)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(FreeImage
+    REQUIRED_VARS FreeImage_LIBRARY FreeImage_INCLUDE_DIR
+)
+
+if(FreeImage_FOUND AND NOT TARGET FreeImage::FreeImage)
+    add_library(FreeImage::FreeImage UNKNOWN IMPORTED)
+    set_target_properties(FreeImage::FreeImage PROPERTIES
+        IMPORTED_LOCATION "${FreeImage_LIBRARY}"
+        INTERFACE_INCLUDE_DIRECTORIES "${FreeImage_INCLUDE_DIR}"
+    )
+endif()
+
+mark_as_advanced(FreeImage_INCLUDE_DIR FreeImage_LIBRARY)
@@ -0,0 +1,355 @@
+#include "gif_encoder.h"
+#include <algorithm>
+
+// Ukuran tabel hash LZW (bilangan prima, sekitar 1.25 x 4096 kode)
+static const int LZW_HASH_SIZE = 5003;
+
+// ===== Palet median cut =====
+
+struct WeightedColor {
+    BYTE channels[3];
+    unsigned long long weight;
+};
+
+// Kotak median cut: rentang [begin, end) pada array warna
+struct ColorBox {
+    size_t begin, end;
+    int channel;
+    int range;
+};
+
+// Fungsi untuk mencari channel dengan rentang nilai terbesar di dalam kotak
+static void measureColorBox(const std::vector<WeightedColor>& colors, ColorBox& box) {
+    BYTE minimum[3] = {255, 255, 255};
+    BYTE maximum[3] = {0, 0, 0};
+    for (size_t i = box.begin; i < box.end; i++) {
+        for (int c = 0; c < 3; c++) {
+            minimum[c] = std::min(minimum[c], colors[i].channels[c]);
+            maximum[c] = std::max(maximum[c], colors[i].channels[c]);
+        }
+    }
+    
+    box.channel = 0;
+    box.range = -1;
+    for (int c = 0; c < 3; c++) {
+        if (maximum[c] - minimum[c] > box.range) {
+            box.channel = c;
+            box.range = maximum[c] - minimum[c];
+        }
+    }
+}
+
+// Fungsi untuk membuat palet hingga maxColors warna dengan median cut berbobot: kotak dengan
+// rentang terbesar dibelah pada median berbobot channel terpanjangnya, warna palet adalah
+// rata-rata berbobot isi setiap kotak
+void buildMedianCutPalette(const std::vector<RGBQUAD>& colors, const std::vector<unsigned long long>& weights,
+                           int maxColors, std::vector<RGBQUAD>& palette) {
+    palette.clear();
+    if (colors.empty() || maxColors <= 0) return;
+    
+    std::vector<WeightedColor> entries(colors.size());
+    for (size_t i = 0; i < colors.size(); i++) {
+        entries[i].channels[0] = colors[i].rgbRed;
+        entries[i].channels[1] = colors[i].rgbGreen;
+        entries[i].channels[2] = colors[i].rgbBlue;
+        entries[i].weight = std::max(1ULL, weights[i]);
+    }
+    
+    std::vector<ColorBox> boxes(1, ColorBox{0, entries.size(), 0, 0});
+    measureColorBox(entries, boxes[0]);
+    
+    while (static_cast<int>(boxes.size()) < maxColors) {
+        int selected = -1;
+        for (size_t b = 0; b < boxes.size(); b++) {
+            if (boxes[b].range > 0 && (selected < 0 || boxes[b].range > boxes[selected].range)) {
+                selected = static_cast<int>(b);
+            }
+        }
+        if (selected < 0) break;
+        
+        ColorBox box = boxes[selected];
+        int channel = box.channel;
+        std::sort(entries.begin() + box.begin, entries.begin() + box.end,
+                  [channel](const WeightedColor& a, const WeightedColor& b) {
+                      return a.channels[channel] < b.channels[channel];
+                  });
+        
+        unsigned long long total = 0;
+        for (size_t i = box.begin; i < box.end; i++) {
+            total += entries[i].weight;
+        }
+        
+        // Titik belah pertama yang bobot kumulatifnya mencapai separuh, minimal satu warna per sisi
+        size_t split = box.begin + 1;
+        unsigned long long cumulative = entries[box.begin].weight;
+        while (split < box.end - 1 && 2 * cumulative < total) {
+            cumulative += entries[split].weight;
+            split++;
+        }
+        
+        ColorBox lower = {box.begin, split, 0, 0};
+        ColorBox upper = {split, box.end, 0, 0};
+        measureColorBox(entries, lower);
+        measureColorBox(entries, upper);
+        boxes[selected] = lower;
+        boxes.push_back(upper);
+    }
+    
+    for (const ColorBox& box : boxes) {
+        unsigned long long sum[3] = {0, 0, 0};
+        unsigned long long total = 0;
+        for (size_t i = box.begin; i < box.end; i++) {
+            for (int c = 0; c < 3; c++) {
+                sum[c] += entries[i].channels[c] * entries[i].weight;
+            }
+            total += entries[i].weight;
+        }
+        
+        RGBQUAD color = {0, 0, 0, 0};
+        color.rgbRed = static_cast<BYTE>((sum[0] + total / 2) / total);
+        color.rgbGreen = static_cast<BYTE>((sum[1] + total / 2) / total);
+        color.rgbBlue = static_cast<BYTE>((sum[2] + total / 2) / total);
+        palette.push_back(color);
+    }
+}
+
+// Fungsi untuk mencari indeks warna palet terdekat (jarak Euclidean RGB)
+int findNearestPaletteIndex(const std::vector<RGBQUAD>& palette, RGBQUAD color) {
+    int best = 0;
+    int bestDistance = 1 << 30;
+    for (size_t i = 0; i < palette.size(); i++) {
+        int dr = palette[i].rgbRed - color.rgbRed;
+        int dg = palette[i].rgbGreen - color.rgbGreen;
+        int db = palette[i].rgbBlue - color.rgbBlue;
+        int distance = dr * dr + dg * dg + db * db;
+        if (distance < bestDistance) {
+            best = static_cast<int>(i);
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+// ===== LZW =====
+
+// Penulis kode LZW dengan panjang bervariasi, bit paling rendah lebih dulu (urutan GIF)
+struct LZWBitPacker {
+    std::vector<BYTE>& output;
+    unsigned int buffer;
+    int bitCount;
+    
+    explicit LZWBitPacker(std::vector<BYTE>& output) : output(output), buffer(0), bitCount(0) {}
+    
+    void write(int code, int length) {
+        buffer |= static_cast<unsigned int>(code) << bitCount;
+        bitCount += length;
+        while (bitCount >= 8) {
+            output.push_back(static_cast<BYTE>(buffer & 0xFF));
+            buffer >>= 8;
+            bitCount -= 8;
+        }
+    }
+    
+    void flush() {
+        if (bitCount > 0) {
+            output.push_back(static_cast<BYTE>(buffer & 0xFF));
+            buffer = 0;
+            bitCount = 0;
+        }
+    }
+};
+
+// Fungsi untuk mengompresi indeks palet dengan LZW versi GIF. Kamus (awalan, simbol) -> kode
+// disimpan di tabel hash open addressing; saat kode 4096 habis, clear code dikirim dan kamus
+// dimulai ulang.
+void compressLZW(const BYTE* indices, size_t count, int minCodeSize, std::vector<BYTE>& output) {
+    const int clearCode = 1 << minCodeSize;
+    const int endCode = clearCode + 1;
+    const int maxCodes = 1 << GIF_MAX_CODE_BITS;
+    
+    std::vector<int> hashKeys(LZW_HASH_SIZE, -1);
+    std::vector<short> hashCodes(LZW_HASH_SIZE, 0);
+    
+    LZWBitPacker packer(output);
+    int codeSize = minCodeSize + 1;
+    int nextCode = endCode + 1;
+    
+    // Panjang kode bertambah begitu kode berikutnya tidak lagi muat, seperti pada decoder
+    auto emit = [&](int code) {
+        packer.write(code, codeSize);
+        if (nextCode > (1 << codeSize) - 1 && codeSize < GIF_MAX_CODE_BITS) {
+            codeSize++;
+        }
+    };
+    
+    emit(clearCode);
+    if (count == 0) {
+        emit(endCode);
+        packer.flush();
+        return;
+    }
+    
+    int prefix = indices[0];
+    for (size_t i = 1; i < count; i++) {
+        int symbol = indices[i];
+        int key = (prefix << 8) | symbol;
+        int slot = ((symbol << 4) ^ prefix) % LZW_HASH_SIZE;
+        
+        while (hashKeys[slot] != -1 && hashKeys[slot] != key) {
+            slot = slot + 1 == LZW_HASH_SIZE ? 0 : slot + 1;
+        }
+        
+        if (hashKeys[slot] == key) {
+            prefix = hashCodes[slot];
+            continue;
+        }
+        
+        emit(prefix);
+        if (nextCode < maxCodes) {
+            hashKeys[slot] = key;
+            hashCodes[slot] = static_cast<short>(nextCode++);
+        } else {
+            emit(clearCode);
+            std::fill(hashKeys.begin(), hashKeys.end(), -1);
+            codeSize = minCodeSize + 1;
+            nextCode = endCode + 1;
+        }
+        prefix = symbol;
+    }
+    
+    emit(prefix);
+    emit(endCode);
+    packer.flush();
+}
+
+// ===== File =====
+
+static void writeU16(std::vector<BYTE>& output, int value) {
+    output.push_back(static_cast<BYTE>(value & 0xFF));
+    output.push_back(static_cast<BYTE>((value >> 8) & 0xFF));
+}
+
+static void writeBytes(std::vector<BYTE>& output, const char* bytes, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        output.push_back(static_cast<BYTE>(bytes[i]));
+    }
+}
+
+// Fungsi untuk menghitung jumlah bit palet GIF (ukuran palet harus pangkat dua, minimal 2 warna)
+static int paletteBitsFor(size_t colorCount) {
+    int bits = 1;
+    while ((static_cast<size_t>(1) << bits) < colorCount) {
+        bits++;
+    }
+    return bits;
+}
+
+static void writePalette(std::vector<BYTE>& output, const std::vector<RGBQUAD>& palette, int bits) {
+    for (int i = 0; i < (1 << bits); i++) {
+        RGBQUAD color = i < static_cast<int>(palette.size()) ? palette[i] : RGBQUAD{0, 0, 0, 0};
+        output.push_back(color.rgbRed);
+        output.push_back(color.rgbGreen);
+        output.push_back(color.rgbBlue);
+    }
+}
+
+// Fungsi untuk membuka file GIF dan menulis header, logical screen beserta palet global,
+// serta ekstensi loop
+bool openGIF(GifWriter& writer, const std::string& path, int width, int height,
+             const std::vector<RGBQUAD>& globalPalette, int loopCount) {
+    if (width <= 0 || height <= 0 || width > GIF_MAX_DIMENSION || height > GIF_MAX_DIMENSION) {
+        return false;
+    }
+    if (globalPalette.empty() || globalPalette.size() > 256) {
+        return false;
+    }
+    
+    writer.file.open(path.c_str(), std::ios::binary);
+    if (!writer.file) return false;
+    writer.width = width;
+    writer.height = height;
+    writer.globalPaletteBits = paletteBitsFor(globalPalette.size());
+    
+    std::vector<BYTE> header;
+    writeBytes(header, "GIF89a", 6);
+    writeU16(header, width);
+    writeU16(header, height);
+    header.push_back(static_cast<BYTE>(0x80 | (writer.globalPaletteBits - 1)));
+    header.push_back(0);  // indeks warna latar
+    header.push_back(0);  // rasio aspek pixel
+    
+    writePalette(header, globalPalette, writer.globalPaletteBits);
+    
+    // Ekstensi aplikasi NETSCAPE2.0 untuk jumlah perulangan animasi (0 = tanpa henti)
+    header.push_back(0x21);
+    header.push_back(0xFF);
+    header.push_back(11);
+    writeBytes(header, "NETSCAPE2.0", 11);
+    header.push_back(3);
+    header.push_back(1);
+    writeU16(header, loopCount);
+    header.push_back(0);
+    
+    return writeGIFBlock(writer, header);
+}
+
+// Fungsi untuk meng-encode satu frame (delay dalam seperseratus detik) menjadi blok byte GIF.
+// Frame boleh hanya berupa sebagian layar; pixel di luarnya tetap menampilkan frame sebelumnya.
+// Writer hanya dibaca, jadi beberapa frame boleh di-encode bersamaan dari thread berbeda.
+bool encodeGIFFrame(const GifWriter& writer, const GifFrame& frame, int delay, std::vector<BYTE>& block) {
+    if (frame.x < 0 || frame.y < 0 || frame.width <= 0 || frame.height <= 0 ||
+        frame.x + frame.width > writer.width || frame.y + frame.height > writer.height ||
+        frame.indices.size() != static_cast<size_t>(frame.width) * frame.height) {
+        return false;
+    }
+    
+    int paletteBits = writer.globalPaletteBits;
+    block.clear();
+    
+    // Graphic control extension: delay, disposal "biarkan frame di tempatnya", dan warna transparan
+    bool transparent = frame.transparentIndex >= 0;
+    block.push_back(0x21);
+    block.push_back(0xF9);
+    block.push_back(4);
+    block.push_back(static_cast<BYTE>(0x04 | (transparent ? 1 : 0)));
+    writeU16(block, delay);
+    block.push_back(static_cast<BYTE>(transparent ? frame.transparentIndex : 0));
+    block.push_back(0);
+    
+    // Image descriptor tanpa palet lokal, frame memakai palet global
+    block.push_back(0x2C);
+    writeU16(block, frame.x);
+    writeU16(block, frame.y);
+    writeU16(block, frame.width);
+    writeU16(block, frame.height);
+    block.push_back(0);
+    
+    // Panjang kode minimum LZW tidak boleh kurang dari 2
+    int minCodeSize = std::max(2, paletteBits);
+    std::vector<BYTE> compressed;
+    compressLZW(frame.indices.data(), frame.indices.size(), minCodeSize, compressed);
+    
+    // Data dipecah menjadi sub-block berukuran maksimum 255 byte
+    block.push_back(static_cast<BYTE>(minCodeSize));
+    for (size_t offset = 0; offset < compressed.size(); offset += 255) {
+        size_t length = std::min<size_t>(255, compressed.size() - offset);
+        block.push_back(static_cast<BYTE>(length));
+        block.insert(block.end(), compressed.begin() + offset, compressed.begin() + offset + length);
+    }
+    block.push_back(0);
+    
+    return true;
+}
+
+// Fungsi untuk menulis blok byte yang sudah di-encode ke file GIF
+bool writeGIFBlock(GifWriter& writer, const std::vector<BYTE>& block) {
+    writer.file.write(reinterpret_cast<const char*>(block.data()), block.size());
+    return static_cast<bool>(writer.file);
+}
+
+// Fungsi untuk menulis trailer dan menutup file GIF
+bool closeGIF(GifWriter& writer) {
+    writer.file.put(0x3B);
+    writer.file.close();
+    return !writer.file.fail();
+}
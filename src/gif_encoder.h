@@ -0,0 +1,48 @@
+#ifndef GIF_ENCODER_H
+#define GIF_ENCODER_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "quadtree.h"
+
+// Encoder GIF89a animasi tanpa library eksternal. Semua frame memakai satu palet global
+// (maksimum 256 warna) dan dikompresi dengan LZW variabel 3-12 bit.
+const int GIF_MAX_CODE_BITS = 12;
+const int GIF_MAX_DIMENSION = 65535;
+
+// Frame yang sudah dikuantisasi: satu indeks palet global per pixel, baris teratas lebih dulu.
+// Frame boleh hanya menutupi sebagian layar mulai dari (x, y), dihitung dari kiri atas.
+struct GifFrame {
+    int x, y;
+    int width, height;
+    std::vector<BYTE> indices;
+    int transparentIndex;  // -1 jika frame tidak memiliki warna transparan
+};
+
+// File GIF yang sedang ditulis
+struct GifWriter {
+    std::ofstream file;
+    int width, height;
+    int globalPaletteBits;  // Jumlah bit palet global
+};
+
+// Fungsi untuk membuat palet dengan median cut berbobot dan mencari warna palet terdekat
+void buildMedianCutPalette(const std::vector<RGBQUAD>& colors, const std::vector<unsigned long long>& weights,
+                           int maxColors, std::vector<RGBQUAD>& palette);
+int findNearestPaletteIndex(const std::vector<RGBQUAD>& palette, RGBQUAD color);
+
+// Fungsi untuk mengompresi indeks palet dengan LZW versi GIF (belum dipecah menjadi sub-block)
+void compressLZW(const BYTE* indices, size_t count, int minCodeSize, std::vector<BYTE>& output);
+
+// Fungsi untuk menulis GIF animasi: header, frame satu per satu, lalu trailer
+bool openGIF(GifWriter& writer, const std::string& path, int width, int height,
+             const std::vector<RGBQUAD>& globalPalette, int loopCount = 0);
+
+// Fungsi untuk memisahkan encode frame dari penulisannya: encodeGIFFrame boleh dipanggil
+// paralel untuk writer yang sama, lalu bloknya ditulis berurutan dengan writeGIFBlock
+bool encodeGIFFrame(const GifWriter& writer, const GifFrame& frame, int delay, std::vector<BYTE>& block);
+bool writeGIFBlock(GifWriter& writer, const std::vector<BYTE>& block);
+bool closeGIF(GifWriter& writer);
+
+#endif
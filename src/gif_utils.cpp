@@ -1,153 +1,327 @@
 #include "quadtree.h"
+#include "gif_encoder.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <condition_variable>
 #include <iostream>
-#include <sstream>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
-#include <cstdio>
-#include <sys/stat.h>
-#include <functional>
+#include <unordered_map>
 
-bool fileExists(const std::string& filename) {
-    struct stat buffer;
-    return (stat(filename.c_str(), &buffer) == 0);
+// Delay antar frame GIF dalam seperseratus detik
+static const int GIF_FRAME_DELAY = 50;
+
+// Jumlah warna palet global animasi, satu indeks sisanya untuk warna transparan
+static const size_t GIF_ANIMATION_COLORS = 255;
+
+// Batas frame yang sudah di-encode tetapi belum ditulis, per thread
+static const int GIF_FRAMES_PER_THREAD = 2;
+
+// Jumlah warna per task saat memetakan warna node ke palet secara paralel
+static const size_t PALETTE_MAPPING_CHUNK = 16384;
+
+// Fungsi untuk mendapatkan kedalaman maksimum quadtree
+int getQuadTreeDepth(const QuadTree& tree) {
+    if (tree.nodes.empty()) return 0;
+    
+    // Anak selalu disimpan setelah induknya, jadi kedalaman cukup dihitung dengan
+    // satu kali iterasi maju pada array node
+    std::vector<int> depths(tree.nodes.size(), 0);
+    int maxDepth = 0;
+    
+    for (size_t i = 0; i < tree.nodes.size(); i++) {
+        const QuadTreeNode& node = tree.nodes[i];
+        maxDepth = std::max(maxDepth, depths[i]);
+        
+        if (!node.isLeaf()) {
+            for (int quadrant = 0; quadrant < 4; quadrant++) {
+                depths[node.firstChild + quadrant] = depths[i] + 1;
+            }
+        }
+    }
+    
+    return maxDepth;
 }
 
-// Fungsi untuk membuat frame dari quadtree untuk kedalaman tertentu
-FIBITMAP* createFrameAtDepth(QuadTreeNode* root, int width, int height, int maxDepth) {
-    FIBITMAP* frameBitmap = FreeImage_Allocate(width, height, 24);
-    if (!frameBitmap) {
-        std::cerr << "Error: Gagal mengalokasikan memori untuk frame!" << std::endl;
-        return nullptr;
+// Fungsi untuk mengelompokkan node internal berdasarkan kedalamannya dalam satu kali iterasi
+// maju (anak selalu disimpan setelah induknya), mengembalikan kedalaman maksimum pohon
+static int bucketSplitNodesByDepth(const QuadTree& tree, std::vector<std::vector<int>>& splitsByDepth) {
+    std::vector<int> depths(tree.nodes.size(), 0);
+    int maxDepth = 0;
+    
+    splitsByDepth.clear();
+    for (size_t i = 0; i < tree.nodes.size(); i++) {
+        const QuadTreeNode& node = tree.nodes[i];
+        maxDepth = std::max(maxDepth, depths[i]);
+        if (node.isLeaf()) continue;
+        
+        if (static_cast<int>(splitsByDepth.size()) <= depths[i]) {
+            splitsByDepth.resize(depths[i] + 1);
+        }
+        splitsByDepth[depths[i]].push_back(static_cast<int>(i));
+        
+        for (int quadrant = 0; quadrant < 4; quadrant++) {
+            depths[node.firstChild + quadrant] = depths[i] + 1;
+        }
     }
+    
+    return maxDepth;
+}
 
-    std::function<void(QuadTreeNode*, int)> drawNodesUpToDepth = 
-        [&frameBitmap, &drawNodesUpToDepth, maxDepth](QuadTreeNode* node, int depth) {
-        if (!node) return;
+// Fungsi untuk membuat palet global animasi beserta indeks palet setiap node. Jika seluruh warna
+// node (semua warna yang bisa muncul di frame mana pun) tidak lebih dari 255, palet berisi warna
+// persis; jika lebih, palet dibuat dengan median cut dari warna daun berbobot luasnya. Satu
+// indeks terakhir disisakan sebagai warna transparan. Pencarian warna palet terdekat dibagi
+// ke thread pool jika ada.
+static void buildTreePalette(const QuadTree& tree, std::vector<RGBQUAD>& palette, std::vector<BYTE>& nodeColors,
+                             ThreadPool* pool) {
+    std::unordered_map<unsigned int, int> colorIndex;
+    std::vector<RGBQUAD> distinctColors;
+    std::vector<unsigned long long> leafAreas;
+    std::vector<int> nodeDistinct(tree.nodes.size());
+    
+    for (size_t i = 0; i < tree.nodes.size(); i++) {
+        const QuadTreeNode& node = tree.nodes[i];
+        unsigned int key = (static_cast<unsigned int>(node.avgColor.rgbRed) << 16) |
+                           (node.avgColor.rgbGreen << 8) | node.avgColor.rgbBlue;
         
-        if (node->isLeaf || depth >= maxDepth) {
-            for (int j = node->y; j < node->y + node->height; j++) {
-                for (int i = node->x; i < node->x + node->width; i++) {
-                    FreeImage_SetPixelColor(frameBitmap, i, j, &node->avgColor);
-                }
+        auto found = colorIndex.find(key);
+        if (found == colorIndex.end()) {
+            found = colorIndex.emplace(key, static_cast<int>(distinctColors.size())).first;
+            distinctColors.push_back(node.avgColor);
+            leafAreas.push_back(0);
+        }
+        
+        nodeDistinct[i] = found->second;
+        if (node.isLeaf()) {
+            leafAreas[found->second] += static_cast<unsigned long long>(node.width) * node.height;
+        }
+    }
+    
+    std::vector<BYTE> distinctToPalette(distinctColors.size());
+    if (distinctColors.size() <= GIF_ANIMATION_COLORS) {
+        palette = distinctColors;
+        for (size_t k = 0; k < distinctColors.size(); k++) {
+            distinctToPalette[k] = static_cast<BYTE>(k);
+        }
+    } else {
+        std::vector<RGBQUAD> leafColors;
+        std::vector<unsigned long long> leafWeights;
+        for (size_t k = 0; k < distinctColors.size(); k++) {
+            if (leafAreas[k] == 0) continue;
+            leafColors.push_back(distinctColors[k]);
+            leafWeights.push_back(leafAreas[k]);
+        }
+        
+        buildMedianCutPalette(leafColors, leafWeights, GIF_ANIMATION_COLORS, palette);
+        
+        auto mapColors = [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; k++) {
+                distinctToPalette[k] = static_cast<BYTE>(findNearestPaletteIndex(palette, distinctColors[k]));
             }
+        };
+        
+        if (pool) {
+            TaskGroup group(*pool);
+            for (size_t begin = 0; begin < distinctColors.size(); begin += PALETTE_MAPPING_CHUNK) {
+                size_t end = std::min(distinctColors.size(), begin + PALETTE_MAPPING_CHUNK);
+                group.run([&mapColors, begin, end] { mapColors(begin, end); });
+            }
+            group.wait();
         } else {
-            drawNodesUpToDepth(node->topLeft, depth + 1);
-            drawNodesUpToDepth(node->topRight, depth + 1);
-            drawNodesUpToDepth(node->bottomLeft, depth + 1);
-            drawNodesUpToDepth(node->bottomRight, depth + 1);
+            mapColors(0, distinctColors.size());
         }
-    };
-    
-    drawNodesUpToDepth(root, 0);
+    }
     
-    return frameBitmap;
+    nodeColors.resize(tree.nodes.size());
+    for (size_t i = 0; i < tree.nodes.size(); i++) {
+        nodeColors[i] = distinctToPalette[nodeDistinct[i]];
+    }
 }
 
-// Fungsi untuk mendapatkan kedalaman maksimum quadtree
-int getQuadTreeDepth(QuadTreeNode* node) {
-    if (!node) return 0;
-    if (node->isLeaf) return 0;
+// Fungsi untuk mewarnai blok node pada frame GIF. Baris frame berurutan dari atas ke bawah,
+// sedangkan koordinat node mengikuti scanline FreeImage (bawah ke atas).
+static void fillFrameRectangle(GifFrame& frame, int screenHeight, const QuadTreeNode& node, BYTE index) {
+    int top = screenHeight - (node.y + node.height) - frame.y;
+    for (int row = top; row < top + node.height; row++) {
+        BYTE* start = frame.indices.data() + static_cast<size_t>(row) * frame.width + (node.x - frame.x);
+        std::fill(start, start + node.width, index);
+    }
+}
+
+// Fungsi untuk membuat frame animasi kedalaman tertentu: hanya anak dari node yang dibagi pada
+// kedalaman sebelumnya dan warnanya berbeda dari induknya, di dalam persegi terkecil yang
+// mencakup anak-anak tersebut; pixel lain transparan sehingga frame sebelumnya tetap terlihat.
+// Frame hanya bergantung pada tree, jadi setiap kedalaman bisa dibuat secara independen.
+static void buildAnimationFrame(const QuadTree& tree, const std::vector<std::vector<int>>& splitsByDepth,
+                                const std::vector<BYTE>& nodeColors, BYTE transparent, int depth, GifFrame& frame) {
+    int width = tree.root().width;
+    int height = tree.root().height;
     
-    int topLeftDepth = getQuadTreeDepth(node->topLeft);
-    int topRightDepth = getQuadTreeDepth(node->topRight);
-    int bottomLeftDepth = getQuadTreeDepth(node->bottomLeft);
-    int bottomRightDepth = getQuadTreeDepth(node->bottomRight);
+    // Node yang warnanya berubah dibanding frame sebelumnya, frame pertama berisi akar
+    std::vector<int> changedNodes;
+    if (depth == 0) {
+        changedNodes.push_back(0);
+    } else {
+        for (int index : splitsByDepth[depth - 1]) {
+            int firstChild = tree.nodes[index].firstChild;
+            for (int child = firstChild; child < firstChild + 4; child++) {
+                if (nodeColors[child] != nodeColors[index]) {
+                    changedNodes.push_back(child);
+                }
+            }
+        }
+    }
+    
+    // Persegi terkecil yang mencakup semua node yang berubah (koordinat node)
+    int left = width, bottom = height, right = 0, top = 0;
+    for (int index : changedNodes) {
+        const QuadTreeNode& node = tree.nodes[index];
+        left = std::min(left, node.x);
+        bottom = std::min(bottom, node.y);
+        right = std::max(right, node.x + node.width);
+        top = std::max(top, node.y + node.height);
+    }
     
-    int maxChildDepth = std::max(
-        std::max(topLeftDepth, topRightDepth),
-        std::max(bottomLeftDepth, bottomRightDepth)
-    );
+    // Tidak ada perubahan warna: frame transparan 1x1 agar jumlah frame dan jedanya tetap
+    if (changedNodes.empty()) {
+        left = 0;
+        bottom = height - 1;
+        right = 1;
+        top = height;
+    }
+    
+    frame.x = left;
+    frame.y = height - top;
+    frame.width = right - left;
+    frame.height = top - bottom;
+    frame.transparentIndex = transparent;
+    frame.indices.assign(static_cast<size_t>(frame.width) * frame.height, transparent);
     
-    return maxChildDepth + 1;
+    for (int index : changedNodes) {
+        fillFrameRectangle(frame, height, tree.nodes[index], nodeColors[index]);
+    }
 }
 
-// Fungsi untuk menyimpan GIF
-bool saveGIF(FIBITMAP* originalImage, QuadTreeNode* root, const std::string& outputPath, bool useMagickExe) {
-    int width = FreeImage_GetWidth(originalImage);
-    int height = FreeImage_GetHeight(originalImage);
+// Fungsi untuk menyimpan GIF: setiap frame dikompresi LZW langsung ke file output tanpa file
+// sementara maupun program eksternal, dengan satu palet global untuk seluruh frame. Dengan
+// lebih dari satu thread, frame dibuat dan di-encode paralel oleh thread pool sementara thread
+// pemanggil menulis blok hasilnya sesuai urutan; paling banyak GIF_FRAMES_PER_THREAD frame per
+// thread yang boleh selesai lebih dulu sebelum ditulis, agar memori tetap terbatas.
+bool saveGIF(const QuadTree& tree, const std::string& outputPath, int threadCount) {
+    if (tree.nodes.empty()) return false;
     
-    int maxDepth = getQuadTreeDepth(root);
+    int width = tree.root().width;
+    int height = tree.root().height;
+    
+    std::vector<std::vector<int>> splitsByDepth;
+    int maxDepth = bucketSplitNodesByDepth(tree, splitsByDepth);
     std::cout << "Kedalaman pohon quadtree: " << maxDepth << std::endl;
     
-    std::vector<std::string> frameFilenames;
+    // Tanpa pool, semua pekerjaan dilakukan oleh thread ini
+    std::unique_ptr<ThreadPool> pool;
+    if (threadCount > 1) {
+        pool.reset(new ThreadPool(threadCount));
+    }
     
-    // buat nampilin frame original tapi di-disable biar ga ikut masuk frame originalnya
-    // std::string originalFrame = "frame_original.png";
-    // frameFilenames.push_back(originalFrame);
-    // FreeImage_Save(FIF_PNG, originalImage, originalFrame.c_str(), 0);
+    std::vector<RGBQUAD> palette;
+    std::vector<BYTE> nodeColors;
+    buildTreePalette(tree, palette, nodeColors, pool.get());
     
-    for (int depth = 0; depth <= maxDepth; depth++) {
-        bool hasNonLeafAtThisDepth = false;
-
-        std::function<void(QuadTreeNode*, int)> checkNode =
-            [&](QuadTreeNode* node, int currentDepth) {
-                if (!node || node->isLeaf) return;
-                if (currentDepth == depth) hasNonLeafAtThisDepth = true;
-                else {
-                    checkNode(node->topLeft, currentDepth + 1);
-                    checkNode(node->topRight, currentDepth + 1);
-                    checkNode(node->bottomLeft, currentDepth + 1);
-                    checkNode(node->bottomRight, currentDepth + 1);
-                }
-            };
-
-        checkNode(root, 0);
-        if (!hasNonLeafAtThisDepth) {
-            std::cout << "Tidak ada node non-leaf pada depth " << depth << ", menghentikan frame di sini." << std::endl;
-            break;
+    BYTE transparent = static_cast<BYTE>(palette.size());
+    palette.push_back(RGBQUAD{0, 0, 0, 0});
+    
+    GifWriter writer;
+    if (!openGIF(writer, outputPath, width, height, palette)) {
+        std::cerr << "Error: Gagal membuka file GIF " << outputPath << " untuk ditulis" << std::endl;
+        return false;
+    }
+    
+    // Frame dibuat untuk setiap kedalaman yang masih memiliki node non-leaf
+    int frameCount = static_cast<int>(splitsByDepth.size());
+    
+    // Hasil encode setiap frame: status 0 = belum selesai, 1 = berhasil, 2 = gagal
+    std::vector<std::vector<BYTE>> blocks(frameCount);
+    std::vector<int> status(frameCount, 0);
+    std::mutex statusMutex;
+    std::condition_variable frameReady;
+    
+    auto encodeFrame = [&](int depth) {
+        GifFrame frame;
+        std::vector<BYTE> block;
+        buildAnimationFrame(tree, splitsByDepth, nodeColors, transparent, depth, frame);
+        bool encoded = encodeGIFFrame(writer, frame, GIF_FRAME_DELAY, block);
+        
+        {
+            std::lock_guard<std::mutex> lock(statusMutex);
+            blocks[depth].swap(block);
+            status[depth] = encoded ? 1 : 2;
         }
-
-        std::cout << "Membuat frame untuk kedalaman " << depth << "..." << std::endl;
-        FIBITMAP* frameBitmap = createFrameAtDepth(root, width, height, depth);
-        if (!frameBitmap) {
-            std::cerr << "Error: Gagal membuat frame untuk kedalaman " << depth << std::endl;
-            continue;
+        frameReady.notify_all();
+    };
+    
+    // Tanpa pool, frame langsung di-encode oleh thread ini tepat sebelum ditulis
+    int window = pool ? GIF_FRAMES_PER_THREAD * threadCount : 1;
+    int submitted = 0;
+    bool success = true;
+    
+    for (int depth = 0; depth < frameCount; depth++) {
+        for (; submitted < frameCount && submitted < depth + window; submitted++) {
+            int next = submitted;
+            if (pool) {
+                pool->submit([&encodeFrame, next] { encodeFrame(next); });
+            } else {
+                encodeFrame(next);
+            }
         }
         
-        std::string frameFile = "frame_" + std::to_string(depth) + ".png";
-        frameFilenames.push_back(frameFile);
+        // Selama menunggu, thread ini ikut mengerjakan frame yang masih antri di pool
+        while (pool) {
+            {
+                std::lock_guard<std::mutex> lock(statusMutex);
+                if (status[depth] != 0) break;
+            }
+            if (!pool->runPendingTask()) {
+                std::unique_lock<std::mutex> lock(statusMutex);
+                frameReady.wait(lock, [&] { return status[depth] != 0; });
+                break;
+            }
+        }
         
-        if (!FreeImage_Save(FIF_PNG, frameBitmap, frameFile.c_str(), 0)) {
-            std::cerr << "Error: Gagal menyimpan frame " << depth << std::endl;
+        std::cout << "Membuat frame untuk kedalaman " << depth << "..." << std::endl;
+        
+        std::vector<BYTE> block;
+        int frameStatus;
+        {
+            std::lock_guard<std::mutex> lock(statusMutex);
+            block.swap(blocks[depth]);
+            frameStatus = status[depth];
         }
         
-        FreeImage_Unload(frameBitmap);
+        if (frameStatus != 1 || !writeGIFBlock(writer, block)) {
+            std::cerr << "Error: Gagal menulis frame " << depth << std::endl;
+            success = false;
+            break;
+        }
     }
     
-    std::ostringstream cmd;
+    // Tunggu frame yang masih dikerjakan sebelum state-nya dibuang
+    pool.reset();
     
-    if (useMagickExe) {
-        cmd << "magick.exe -delay 50 -loop 0";
-    } else {
-        cmd << "convert -delay 50 -loop 0";
+    if (success && frameCount <= maxDepth) {
+        std::cout << "Tidak ada node non-leaf pada depth " << frameCount << ", menghentikan frame di sini." << std::endl;
     }
     
-    for (const auto& frame : frameFilenames) {
-        if (fileExists(frame)) {
-            cmd << " " << frame;
-        } else {
-            std::cerr << "Peringatan: File frame " << frame << " tidak ditemukan." << std::endl;
-        }
+    if (!closeGIF(writer)) {
+        success = false;
     }
     
-    cmd << " " << outputPath;
-    
-    std::cout << "Menjalankan perintah: " << cmd.str() << std::endl;
-    int ret = system(cmd.str().c_str());
-    
-    if (ret != 0) {
-        std::cerr << "Error: Gagal membuat GIF menggunakan ImageMagick. Kode error: " << ret << std::endl;
-    } else {
+    if (success) {
         std::cout << "GIF berhasil dibuat!" << std::endl;
+    } else {
+        std::cerr << "Error: Gagal membuat GIF " << outputPath << std::endl;
     }
-    
-    for (const auto& frame : frameFilenames) {
-        if (fileExists(frame)) {
-            if (std::remove(frame.c_str()) != 0) {
-                std::cerr << "Error: Gagal menghapus frame sementara " << frame << std::endl;
-            }
-        }
-    }
-    
-    return (ret == 0);
-}
\ No newline at end of file
+    return success;
+}
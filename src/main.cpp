@@ -1,32 +1,355 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <string>
+#include <vector>
 #include <chrono>
 #include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
 #include "quadtree.h"
+#include "simd_kernels.h"
+#include "qtc_format.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
+#include "metrics.h"
+#include "verify.h"
+#include "tiled.h"
 
 using namespace std;
+namespace fs = std::filesystem;
 
-int main() {
-    FreeImage_Initialise();
+// Parameter kompresi satu gambar, diisi dari input interaktif atau dari flag
+struct CompressionOptions {
+    int method = 1;
+    double threshold = 0;
+    int minBlockSize = 4;
+    double targetCompression = 0;
+    unsigned long long maxCompressedSize = 0;
+    string outputPath;
+    string gifPath;
+    bool progressive = false;
+    int threadCount = 1;
+    bool phasePeakMemory = true;    // false jika beberapa gambar diproses bersamaan
+};
+
+// Fungsi untuk mengecek ekstensi file (tidak membedakan huruf besar dan kecil)
+static bool hasExtension(const string& path, const string& extension) {
+    size_t dot = path.find_last_of('.');
+    if (dot == string::npos) return false;
+    
+    string actual = path.substr(dot + 1);
+    transform(actual.begin(), actual.end(), actual.begin(), ::tolower);
+    return actual == extension;
+}
+
+// Fungsi untuk menyimpan ImageView ke file gambar, format ditentukan dari ekstensi
+static bool saveImageView(const ImageView& view, const string& outputPath, ostream& log) {
+    FIBITMAP* outputImage = createBitmapFromView(view);
+    if (!outputImage) {
+        log << "Gagal membuat gambar output!" << endl;
+        return false;
+    }
     
-    FreeImage_SetOutputMessage([](FREE_IMAGE_FORMAT fif, const char *message) {
-        cout << "FreeImage Error";
-        if (fif != FIF_UNKNOWN) {
-            cout << " (" << FreeImage_GetFormatFromFIF(fif) << ")";
+    FREE_IMAGE_FORMAT outputFormat = FreeImage_GetFIFFromFilename(outputPath.c_str());
+    if (outputFormat == FIF_UNKNOWN) {
+        outputFormat = FIF_PNG; 
+    }
+    
+    if (!FreeImage_FIFSupportsWriting(outputFormat)) {
+        log << "Format output tidak didukung untuk penyimpanan. Menggunakan PNG sebagai gantinya." << endl;
+        outputFormat = FIF_PNG;
+    }
+    
+    bool saveSuccess = FreeImage_Save(outputFormat, outputImage, outputPath.c_str());
+    FreeImage_Unload(outputImage);
+    
+    if (!saveSuccess) {
+        log << "Gagal menyimpan gambar output!" << endl;
+    }
+    return saveSuccess;
+}
+
+// Mode decode: file .qtc dipetakan ke memori lalu dirender langsung ke bitmap output
+static int decodeQTCFile(const string& inputPath, const string& outputPath) {
+    auto startTime = chrono::high_resolution_clock::now();
+    
+    MappedFile file;
+    QTCHeader header;
+    if (!mapFile(inputPath, file)) {
+        cout << "Gagal membuka file .qtc!" << endl;
+        return 1;
+    }
+    if (!readQTCHeader(file.data, file.size, header)) {
+        cout << "File bukan file .qtc yang valid!" << endl;
+        unmapFile(file);
+        return 1;
+    }
+    
+    FIBITMAP* outputImage = FreeImage_Allocate(header.width, header.height, 24);
+    if (!outputImage) {
+        cout << "Gagal membuat gambar output!" << endl;
+        unmapFile(file);
+        return 1;
+    }
+    
+    // Scanline FreeImage 24 bit berurutan B, G, R pada sistem little-endian
+    bool rendered = renderQTC(file.data, file.size, FreeImage_GetBits(outputImage), 
+                              FreeImage_GetPitch(outputImage), FI_RGBA_RED == 2);
+    unmapFile(file);
+    
+    auto endTime = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count();
+    
+    if (!rendered) {
+        cout << "File .qtc rusak atau tidak lengkap!" << endl;
+        FreeImage_Unload(outputImage);
+        return 1;
+    }
+    
+    FREE_IMAGE_FORMAT outputFormat = FreeImage_GetFIFFromFilename(outputPath.c_str());
+    if (outputFormat == FIF_UNKNOWN || !FreeImage_FIFSupportsWriting(outputFormat)) {
+        outputFormat = FIF_PNG;
+    }
+    
+    bool saveSuccess = FreeImage_Save(outputFormat, outputImage, outputPath.c_str());
+    FreeImage_Unload(outputImage);
+    
+    if (!saveSuccess) {
+        cout << "Gagal menyimpan gambar output!" << endl;
+        return 1;
+    }
+    
+    cout << "Gambar hasil decode berhasil disimpan ke: " << outputPath << endl;
+    cout << "\n===== STATISTIK DECODE =====" << endl;
+    cout << "Waktu decode: " << duration << " ms" << endl;
+    cout << "Ukuran gambar: " << header.width << "x" << header.height << " pixel" << endl;
+    cout << "Banyak simpul pada pohon: " << header.nodeCount << endl;
+    
+    return 0;
+}
+
+// Fungsi untuk mengganti parameter yang tidak valid dengan nilai default
+static void validateOptions(CompressionOptions& options, ostream& log) {
+    if (options.method < 1 || options.method > 5) {
+        log << "Metode perhitungan error tidak valid! Menggunakan metode default (Variance)." << endl;
+        options.method = 0;
+    }
+    
+    if (options.minBlockSize <= 0) {
+        log << "Ukuran blok minimum tidak valid! Menggunakan nilai default (4)." << endl;
+        options.minBlockSize = 4;
+    }
+}
+
+// Fungsi untuk mengompresi satu gambar sesuai parameter, semua pesan ditulis ke log
+static bool compressImageFile(const string& inputPath, const CompressionOptions& options, 
+                              ostream& log, CompressionMetrics& metrics) {
+    int method = options.method;
+    double threshold = options.threshold;
+    int minBlockSize = options.minBlockSize;
+    int threadCount = options.threadCount;
+    const string& outputPath = options.outputPath;
+    string gifPath = options.gifPath;
+    
+    resetCompressionMetrics(metrics);
+    metrics.inputPath = inputPath;
+    metrics.outputPath = outputPath;
+    metrics.method = method;
+    metrics.threshold = threshold;
+    metrics.minBlockSize = minBlockSize;
+    metrics.threadCount = threadCount;
+    
+    PhaseClock phase;
+    startPhase(phase, options.phasePeakMemory);
+    
+    // Deteksi format gambar input
+    FREE_IMAGE_FORMAT inputFormat = FreeImage_GetFileType(inputPath.c_str());
+    if (inputFormat == FIF_UNKNOWN) {
+        inputFormat = FreeImage_GetFIFFromFilename(inputPath.c_str());
+    }
+    
+    if (inputFormat == FIF_UNKNOWN || !FreeImage_FIFSupportsReading(inputFormat)) {
+        log << "Format gambar input tidak didukung atau file tidak ditemukan!" << endl;
+        return false;
+    }
+    
+    // Load gambar input
+    FIBITMAP* originalImage = FreeImage_Load(inputFormat, inputPath.c_str());
+    if (!originalImage) {
+        log << "Gagal memuat gambar input!" << endl;
+        return false;
+    }
+    finishPhase(metrics, "decode", phase);
+    
+    startPhase(phase, options.phasePeakMemory);
+    
+    // Salin pixel ke bentuk planar sekali langsung dari bitmap asli, semua kernel bekerja
+    // pada salinan ini (gambar grayscale hanya satu channel)
+    ImageView imageView = createImageView(originalImage);
+    FreeImage_Unload(originalImage);
+    
+    // Dapatkan dimensi gambar
+    int width = imageView.width;
+    int height = imageView.height;
+    finishPhase(metrics, "convert", phase);
+    metrics.width = width;
+    metrics.height = height;
+    
+    log << "\nMemproses gambar " << width << "x" << height << " pixel..." << endl;
+    log << "Kernel error menggunakan instruksi " << getSimdLevelName(getSimdLevel()) << endl;
+    
+    auto startTime = chrono::high_resolution_clock::now();
+    
+    startPhase(phase, options.phasePeakMemory);
+    IntegralImage integral = buildIntegralImage(imageView);
+    finishPhase(metrics, "integral", phase);
+    
+    QuadTree tree;
+    
+    // Jika batas ukuran diaktifkan, bagi blok dengan error terbesar lebih dulu hingga batas
+    // tercapai. Jika target persentase kompresi diaktifkan, bangun pohon penuh sekali,
+    // temukan threshold optimal lalu pangkas pohon tersebut
+    if (options.maxCompressedSize > 0) {
+        int maxNodes = calculateNodeBudget(options.maxCompressedSize);
+        log << "Membangun quadtree dengan batas " << maxNodes << " simpul..." << endl;
+        startPhase(phase, options.phasePeakMemory);
+        tree = buildQuadTreeWithBudget(imageView, integral, minBlockSize, method, maxNodes);
+        finishPhase(metrics, "build", phase);
+        metrics.buildPixels = sumQuadTreeArea(tree);
+    } else if (options.targetCompression > 0) {
+        log << "Mencari threshold optimal untuk target persentase kompresi " << options.targetCompression << "%..." << endl;
+        startPhase(phase, options.phasePeakMemory);
+        FullQuadTree fullTree = buildFullQuadTree(imageView, integral, minBlockSize, method);
+        threshold = findThresholdForTargetCompression(fullTree, imageView, options.targetCompression);
+        finishPhase(metrics, "threshold_search", phase);
+        metrics.buildPixels = sumQuadTreeArea(fullTree.tree);
+        metrics.threshold = threshold;
+        log << "Menggunakan threshold optimal: " << threshold << endl;
+        
+        log << "Membangun quadtree dari pohon penuh..." << endl;
+        startPhase(phase, options.phasePeakMemory);
+        tree = pruneQuadTree(fullTree, threshold);
+        finishPhase(metrics, "build", phase);
+    } else {
+        log << "Membangun quadtree dengan " << threadCount << " thread..." << endl;
+        startPhase(phase, options.phasePeakMemory);
+        tree = buildQuadTreeParallel(imageView, integral, 0, 0, width, height, 
+                                     minBlockSize, threshold, method, threadCount);
+        finishPhase(metrics, "build", phase);
+        metrics.buildPixels = sumQuadTreeArea(tree);
+    }
+    
+    // Buat kanvas output, baru ditulis ke bitmap FreeImage saat disimpan
+    startPhase(phase, options.phasePeakMemory);
+    ImageView outputView = createImageView(width, height);
+    
+    log << "Menggambar hasil kompresi..." << endl;
+    drawQuadTree(outputView, tree);
+    finishPhase(metrics, "draw", phase);
+    metrics.drawPixels = static_cast<unsigned long long>(width) * height;
+    
+    // Hitung statistik quadtree, termasuk jumlah node dan daun per kedalaman
+    collectDepthMetrics(tree, metrics);
+    int nodeCount = metrics.nodeCount;
+    int maxDepth = metrics.maxDepth;
+    
+    // Hitung ukuran dan persentase kompresi
+    DWORD originalSize = static_cast<DWORD>(width) * height * 3; // 3 bytes per pixel untuk RGB
+    unsigned long long compressedSize = calculateCompressedSize(nodeCount);
+    double compressionPercentage = calculateCompressionPercentage(imageView, nodeCount);
+    
+    // Serialisasi tree ke format .qtc untuk mendapatkan ukuran sebenarnya
+    startPhase(phase, options.phasePeakMemory);
+    vector<BYTE> qtcBuffer;
+    bool qtcEncoded = options.progressive ? encodeQTCProgressive(tree, minBlockSize, qtcBuffer)
+                                          : encodeQTC(tree, minBlockSize, qtcBuffer);
+    finishPhase(metrics, "encode", phase);
+    
+    auto endTime = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count();
+    
+    // Simpan hasil kompresi: tree dalam format .qtc, atau gambar hasil render untuk format lain
+    startPhase(phase, options.phasePeakMemory);
+    bool saved = false;
+    if (hasExtension(outputPath, "qtc")) {
+        saved = qtcEncoded && saveQTC(qtcBuffer, outputPath);
+        if (saved) {
+            log << "Quadtree hasil kompresi berhasil disimpan ke: " << outputPath << endl;
+        } else {
+            log << "Gagal menyimpan file .qtc!" << endl;
         }
-        cout << ": " << message << endl;
-    });
+    } else if (saveImageView(outputView, outputPath, log)) {
+        saved = true;
+        log << "Gambar hasil kompresi berhasil disimpan ke: " << outputPath << endl;
+    }
+    finishPhase(metrics, "save", phase);
+    
+    // Tampilan statistik
+    log << "\n===== STATISTIK KOMPRESI =====" << endl;
+    log << "Waktu eksekusi: " << duration << " ms" << endl;
+    log << "Ukuran gambar sebelum: " << originalSize << " bytes" << endl;
+    log << "Ukuran gambar setelah: " << compressedSize << " bytes" << endl;
+    if (qtcEncoded) {
+        log << "Ukuran file .qtc: " << qtcBuffer.size() << " bytes" << endl;
+    }
+    log << "Persentase kompresi: " << compressionPercentage << "%" << endl;
+    log << "Kedalaman pohon: " << maxDepth << endl;
+    log << "Banyak simpul pada pohon: " << nodeCount << endl;
     
-    string inputPath, outputPath, gifPath;
-    int method;
-    double threshold;
-    int minBlockSize;
-    double targetCompression;
+    // Fungsi membuat GIF
+    if (!gifPath.empty()) {
+        log << "\nMemulai proses pembuatan GIF..." << endl;
+
+        string ext = gifPath.substr(gifPath.find_last_of(".") + 1);
+        if (ext != "gif" && ext != "GIF") {
+            log << "Menambahkan ekstensi .gif ke nama file" << endl;
+            gifPath += ".gif";
+        }
+
+        startPhase(phase, options.phasePeakMemory);
+        bool gifSaved = saveGIF(tree, gifPath, threadCount);
+        finishPhase(metrics, "gif", phase);
+        
+        if (gifSaved) {
+            log << "GIF berhasil disimpan ke: " << gifPath << endl;
+        } else {
+            log << "Gagal menyimpan GIF!" << endl;
+        }
+    }
+    
+    tree.clear();
+    
+    metrics.success = saved;
+    metrics.duration = duration;
+    metrics.qtcBytes = qtcEncoded ? qtcBuffer.size() : 0;
+    metrics.compressionPercentage = compressionPercentage;
+    return saved;
+}
+
+// Mode interaktif: semua parameter dibaca dari stdin
+static int runInteractive(int threadCount) {
+    string inputPath;
+    CompressionOptions options;
+    options.threadCount = threadCount;
     
     cout << "===== KOMPRESI GAMBAR DENGAN METODE QUADTREE =====" << endl;
     cout << "Masukkan alamat absolut gambar yang akan dikompresi: ";
     getline(cin, inputPath);
     
+    // File .qtc tidak dikompresi ulang, melainkan di-decode menjadi gambar
+    if (hasExtension(inputPath, "qtc")) {
+        string outputPath;
+        cout << "Masukkan alamat absolut gambar hasil decode: ";
+        getline(cin, outputPath);
+        return decodeQTCFile(inputPath, outputPath);
+    }
+    
     cout << "===== Metode Perhitungan Error =====" << endl;
     cout << "1. Variance" << endl;
     cout << "2. MAD" << endl;
@@ -34,178 +357,459 @@ int main() {
     cout << "4. Entropy" << endl;
     cout << "5. SSIM (Bonus)" << endl;
     cout << "Masukkan metode perhitungan error: ";
-    cin >> method;
+    cin >> options.method;
     
     cout << "Masukkan ambang batas (threshold): ";
-    cin >> threshold;
+    cin >> options.threshold;
     
     cout << "Masukkan ukuran blok minimum: ";
-    cin >> minBlockSize;
+    cin >> options.minBlockSize;
     
     cout << "Masukkan target persentase kompresi (0 untuk menonaktifkan): ";
-    cin >> targetCompression;
+    cin >> options.targetCompression;
     
     cin.ignore();
     
     cout << "Masukkan alamat absolut gambar hasil kompresi: ";
-    getline(cin, outputPath);
+    getline(cin, options.outputPath);
     
     cout << "Masukkan alamat absolut gif (kosongkan untuk melewati): ";
-    getline(cin, gifPath);
+    getline(cin, options.gifPath);
     
-    if (method < 1 || method > 5) {
-        cout << "Metode perhitungan error tidak valid! Menggunakan metode default (Variance)." << endl;
-        method = 0;
-    }
+    validateOptions(options, cout);
     
-    if (minBlockSize <= 0) {
-        cout << "Ukuran blok minimum tidak valid! Menggunakan nilai default (4)." << endl;
-        minBlockSize = 4;
+    CompressionMetrics metrics;
+    if (!compressImageFile(inputPath, options, cout, metrics) && metrics.nodeCount == 0) {
+        return 1;
     }
-    
-    // Deteksi format gambar input
-    FREE_IMAGE_FORMAT inputFormat = FreeImage_GetFileType(inputPath.c_str());
-    if (inputFormat == FIF_UNKNOWN) {
-        inputFormat = FreeImage_GetFIFFromFilename(inputPath.c_str());
+    return 0;
+}
+
+// ===== Mode flag dan batch =====
+
+static void printUsage(const char* program) {
+    cout << "Penggunaan:\n"
+         << "  " << program << "                      (mode interaktif)\n"
+         << "  " << program << " -i INPUT -o OUTPUT [opsi]\n"
+         << "  " << program << " --batch DIREKTORI|DAFTAR --output-dir DIREKTORI [opsi]\n"
+         << "  " << program << " --verify DIREKTORI|DAFTAR [--golden FILE] [--write-golden FILE]\n"
+         << "\nOpsi:\n"
+         << "  -i, --input PATH         gambar input (atau file .qtc untuk di-decode)\n"
+         << "  -o, --output PATH        gambar hasil kompresi (ekstensi .qtc menyimpan Quadtree)\n"
+         << "  -m, --method N           metode error: 1 Variance, 2 MAD, 3 Max Pixel Difference,\n"
+         << "                           4 Entropy, 5 SSIM (default 1)\n"
+         << "  -t, --threshold X        ambang batas error (default 0)\n"
+         << "  -b, --min-block N        ukuran blok minimum (default 4)\n"
+         << "      --target P           target persentase kompresi (0 = nonaktif)\n"
+         << "      --max-bytes N        batas ukuran hasil kompresi dalam bytes (0 = nonaktif)\n"
+         << "      --gif PATH           simpan GIF proses pembentukan Quadtree\n"
+         << "      --progressive        simpan .qtc dalam urutan progresif\n"
+         << "      --tile N             mode tile untuk gambar besar: tile bersisi maksimum N pixel,\n"
+         << "                           input PPM/PGM dibaca dan output PPM ditulis per pita\n"
+         << "      --report PATH        simpan waktu dan memori per tahap serta statistik pohon (JSON)\n"
+         << "  -j, --threads N          jumlah thread (default semua core)\n"
+         << "      --batch PATH         direktori gambar, atau file berisi satu path gambar per baris\n"
+         << "      --output-dir DIR     direktori output mode batch\n"
+         << "      --format EXT         ekstensi output mode batch (default png, atau qtc)\n"
+         << "      --verify PATH        bandingkan semua jalur cepat dengan referensi skalar untuk\n"
+         << "                           setiap gambar di direktori atau file daftar\n"
+         << "      --golden FILE        bandingkan hasil --verify dengan nilai golden\n"
+         << "      --write-golden FILE  simpan hasil --verify sebagai nilai golden\n"
+         << "  -h, --help               tampilkan bantuan ini\n";
+}
+
+// Fungsi untuk membaca angka dari argumen, gagal jika ada karakter sisa
+static bool parseNumber(const string& text, double& value) {
+    char* end = nullptr;
+    value = strtod(text.c_str(), &end);
+    return !text.empty() && end && *end == '\0';
+}
+
+static bool parseInteger(const string& text, long long& value) {
+    char* end = nullptr;
+    value = strtoll(text.c_str(), &end, 10);
+    return !text.empty() && end && *end == '\0';
+}
+
+// Fungsi untuk mengumpulkan gambar mode batch dari direktori (berurutan sesuai nama) atau
+// dari file daftar berisi satu path per baris
+static bool collectBatchInputs(const string& source, vector<string>& inputs) {
+    error_code error;
+    if (fs::is_directory(source, error)) {
+        for (const auto& entry : fs::directory_iterator(source, error)) {
+            if (!entry.is_regular_file(error)) continue;
+            
+            string path = entry.path().string();
+            if (FreeImage_GetFIFFromFilename(path.c_str()) != FIF_UNKNOWN) {
+                inputs.push_back(path);
+            }
+        }
+        sort(inputs.begin(), inputs.end());
+        return !error;
     }
     
-    if (inputFormat == FIF_UNKNOWN || !FreeImage_FIFSupportsReading(inputFormat)) {
-        cout << "Format gambar input tidak didukung atau file tidak ditemukan!" << endl;
-        FreeImage_DeInitialise();
+    ifstream list(source.c_str());
+    if (!list) return false;
+    
+    string line;
+    while (getline(list, line)) {
+        // Abaikan spasi di akhir baris (misalnya \r dari file Windows) dan baris kosong
+        while (!line.empty() && isspace(static_cast<unsigned char>(line.back()))) {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            inputs.push_back(line);
+        }
+    }
+    return true;
+}
+
+// Mode batch: setiap gambar menjadi satu task di thread pool. Setiap gambar dibangun dengan
+// satu thread, paralelisme didapat dari banyaknya gambar yang diproses bersamaan.
+static int runBatch(const string& source, const string& outputDir, const string& format,
+                    const CompressionOptions& baseOptions, const string& reportPath) {
+    vector<string> inputs;
+    if (!collectBatchInputs(source, inputs)) {
+        cout << "Gagal membaca daftar gambar dari " << source << endl;
         return 1;
     }
-    
-    // Load gambar input
-    FIBITMAP* originalImage = FreeImage_Load(inputFormat, inputPath.c_str());
-    if (!originalImage) {
-        cout << "Gagal memuat gambar input!" << endl;
-        FreeImage_DeInitialise();
+    if (inputs.empty()) {
+        cout << "Tidak ada gambar yang dapat diproses pada " << source << endl;
         return 1;
     }
     
-    FIBITMAP* image = FreeImage_ConvertTo24Bits(originalImage);
-    FreeImage_Unload(originalImage);
+    // Nama output hanya dari nama file tanpa ekstensi, jadi misalnya a.png dan a.jpg (atau a.png
+    // dari dua direktori) akan menulis file yang sama; tolak sebelum ada gambar yang diproses
+    vector<string> outputPaths(inputs.size());
+    map<string, size_t> outputOwners;
+    bool collision = false;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        outputPaths[i] = (fs::path(outputDir) / fs::path(inputs[i]).stem()).string() + "." + format;
+        auto owner = outputOwners.insert(make_pair(outputPaths[i], i));
+        if (!owner.second) {
+            cout << "Gambar " << inputs[owner.first->second] << " dan " << inputs[i]
+                 << " akan ditulis ke file output yang sama: " << outputPaths[i] << endl;
+            collision = true;
+        }
+    }
+    if (collision) return 1;
     
-    // Dapatkan dimensi gambar
-    int width = FreeImage_GetWidth(image);
-    int height = FreeImage_GetHeight(image);
+    error_code error;
+    fs::create_directories(outputDir, error);
+    if (!fs::is_directory(outputDir, error)) {
+        cout << "Gagal membuat direktori output " << outputDir << endl;
+        return 1;
+    }
     
-    cout << "\nMemproses gambar " << width << "x" << height << " pixel..." << endl;
+    cout << "Memproses " << inputs.size() << " gambar dengan " << baseOptions.threadCount << " thread..." << endl;
     
     auto startTime = chrono::high_resolution_clock::now();
-    
-    // Jika target persentase kompresi diaktifkan, temukan threshold optimal
-    if (targetCompression > 0) {
-        cout << "Mencari threshold optimal untuk target persentase kompresi " << targetCompression << "%..." << endl;
-        threshold = findThresholdForTargetCompression(image, minBlockSize, method, targetCompression);
-        cout << "Menggunakan threshold optimal: " << threshold << endl;
+    mutex outputMutex;
+    atomic<int> finished(0);
+    atomic<int> failed(0);
+    vector<CompressionMetrics> reports(inputs.size());
+    
+    {
+        ThreadPool pool(baseOptions.threadCount);
+        TaskGroup group(pool);
+        
+        for (size_t i = 0; i < inputs.size(); i++) {
+            group.run([&, i] {
+                const string& inputPath = inputs[i];
+                CompressionOptions options = baseOptions;
+                options.threadCount = 1;
+                // Puncak memori per tahap hanya bermakna jika gambar diproses satu per satu
+                options.phasePeakMemory = pool.threadCount() == 1;
+                options.outputPath = outputPaths[i];
+                
+                // Pesan per gambar dikumpulkan dulu agar tidak bercampur antar thread
+                ostringstream log;
+                CompressionMetrics& result = reports[i];
+                bool success = compressImageFile(inputPath, options, log, result);
+                if (!success) failed++;
+                
+                lock_guard<mutex> lock(outputMutex);
+                int index = ++finished;
+                cout << "[" << index << "/" << inputs.size() << "] " << inputPath;
+                if (success) {
+                    cout << " -> " << options.outputPath << " (" << result.nodeCount << " simpul, "
+                         << result.compressionPercentage << "%, " << result.duration << " ms)" << endl;
+                } else {
+                    cout << " gagal diproses:\n" << log.str();
+                }
+            });
+        }
+        group.wait();
     }
     
-    cout << "Membangun quadtree..." << endl;
-    QuadTreeNode* root = buildQuadTree(image, 0, 0, width, height, minBlockSize, threshold, method);
+    auto endTime = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count();
     
-    // Buat gambar output
-    FIBITMAP* outputImage = FreeImage_Allocate(width, height, 24);
-    if (!outputImage) {
-        cout << "Gagal membuat gambar output!" << endl;
-        FreeImage_Unload(image);
-        delete root;
-        FreeImage_DeInitialise();
+    cout << "\n===== STATISTIK BATCH =====" << endl;
+    cout << "Gambar berhasil: " << inputs.size() - failed << endl;
+    cout << "Gambar gagal: " << failed << endl;
+    cout << "Waktu total: " << duration << " ms" << endl;
+    
+    if (!reportPath.empty() && !saveMetricsJSON(reports, reportPath)) {
+        cout << "Gagal menyimpan laporan metrik ke " << reportPath << endl;
         return 1;
     }
     
-    cout << "Menggambar hasil kompresi..." << endl;
-    drawQuadTree(outputImage, root);
+    return failed > 0 ? 1 : 0;
+}
+
+// Mode verifikasi: setiap gambar diuji dengan semua metode pada beberapa threshold dan ukuran
+// blok minimum. Jalur yang dipercepat dibandingkan dengan referensi skalar, lalu hasil
+// referensi dibandingkan dengan file golden (jika ada) atau disimpan sebagai golden baru.
+static int runVerify(const string& source, const string& goldenPath, const string& writeGoldenPath,
+                     int threadCount) {
+    vector<string> inputs;
+    if (!collectBatchInputs(source, inputs) || inputs.empty()) {
+        cout << "Tidak ada gambar yang dapat diverifikasi pada " << source << endl;
+        return 1;
+    }
     
-    // Hitung statistik quadtree
-    int nodeCount = 0;
-    int maxDepth = 0;
-    calculateQuadTreeStats(root, nodeCount, maxDepth);
+    vector<VerifyCase> golden;
+    if (!goldenPath.empty() && !loadGoldenFile(goldenPath, golden)) {
+        cout << "Gagal membaca file golden " << goldenPath << endl;
+        return 1;
+    }
     
-    // Hitung ukuran dan persentase kompresi
-    DWORD originalSize = static_cast<DWORD>(width) * height * 3; // 3 bytes per pixel untuk RGB
-    DWORD compressedSize = nodeCount * (sizeof(int) * 4 + sizeof(RGBQUAD) + sizeof(bool));
-    double compressionPercentage = calculateCompressionPercentage(image, nodeCount);
+    vector<VerifyCase> cases;
+    int failures = 0;
+    for (const string& inputPath : inputs) {
+        FREE_IMAGE_FORMAT inputFormat = FreeImage_GetFileType(inputPath.c_str());
+        if (inputFormat == FIF_UNKNOWN) {
+            inputFormat = FreeImage_GetFIFFromFilename(inputPath.c_str());
+        }
+        
+        FIBITMAP* originalImage = nullptr;
+        if (inputFormat != FIF_UNKNOWN && FreeImage_FIFSupportsReading(inputFormat)) {
+            originalImage = FreeImage_Load(inputFormat, inputPath.c_str());
+        }
+        if (!originalImage) {
+            cout << inputPath << ": gagal memuat gambar" << endl;
+            failures++;
+            continue;
+        }
+        
+        ImageView imageView = createImageView(originalImage);
+        FreeImage_Unload(originalImage);
+        
+        size_t firstCase = cases.size();
+        int imageFailures = verifyImage(fs::path(inputPath).filename().string(), imageView, threadCount, cases, cout);
+        cout << inputPath << ": " << cases.size() - firstCase << " kasus, "
+             << (imageFailures == 0 ? "semua jalur identik dengan referensi" : "ADA JALUR YANG BERBEDA") << endl;
+        failures += imageFailures;
+    }
     
-    auto endTime = chrono::high_resolution_clock::now();
-    auto duration = chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count();
+    if (!golden.empty()) {
+        int goldenFailures = compareWithGolden(cases, golden, cout);
+        cout << "Perbandingan golden: " << (goldenFailures == 0 ? "sesuai" : "TIDAK SESUAI") << endl;
+        failures += goldenFailures;
+    }
     
-    // Simpan gambar output
-    FREE_IMAGE_FORMAT outputFormat = FreeImage_GetFIFFromFilename(outputPath.c_str());
-    if (outputFormat == FIF_UNKNOWN) {
-        outputFormat = FIF_PNG; 
+    if (!writeGoldenPath.empty()) {
+        if (!saveGoldenFile(writeGoldenPath, cases)) {
+            cout << "Gagal menyimpan file golden " << writeGoldenPath << endl;
+            return 1;
+        }
+        cout << "Nilai golden disimpan ke: " << writeGoldenPath << endl;
     }
     
-    if (!FreeImage_FIFSupportsWriting(outputFormat)) {
-        cout << "Format output tidak didukung untuk penyimpanan. Menggunakan PNG sebagai gantinya." << endl;
-        outputFormat = FIF_PNG;
+    cout << "\n===== HASIL VERIFIKASI =====" << endl;
+    cout << "Kasus diuji: " << cases.size() << endl;
+    cout << "Perbedaan: " << failures << endl;
+    return failures > 0 ? 1 : 0;
+}
+
+// Mode tile: gambar diproses per tile dan output PPM ditulis per pita baris
+static int runTiled(const string& inputPath, const CompressionOptions& options, int tileSize) {
+    if (!hasExtension(options.outputPath, "ppm")) {
+        cout << "Mode tile hanya dapat menulis output PPM (.ppm)" << endl;
+        return 2;
+    }
+    if (options.targetCompression > 0 || options.maxCompressedSize > 0 || !options.gifPath.empty()) {
+        cout << "Mode tile hanya mendukung threshold; --target, --max-bytes dan --gif tidak dapat dipakai" << endl;
+        return 2;
     }
     
-    bool saveSuccess = FreeImage_Save(outputFormat, outputImage, outputPath.c_str());
-    if (!saveSuccess) {
-        cout << "Gagal menyimpan gambar output!" << endl;
-    } else {
-        cout << "Gambar hasil kompresi berhasil disimpan ke: " << outputPath << endl;
+    // Entropy blok besar sering sudah di bawah threshold, sehingga node di atas kedalaman tile
+    // yang selalu dibagi membuat hasilnya berbeda dari mode biasa
+    if (options.method == 4) {
+        cout << "Peringatan: dengan metode Entropy, node di atas kedalaman tile selalu dibagi; "
+             << "hasil mode tile bisa berbeda dari mode biasa" << endl;
     }
     
-    // Tampilan statistik
+    TiledOptions tiledOptions;
+    tiledOptions.method = options.method;
+    tiledOptions.threshold = options.threshold;
+    tiledOptions.minBlockSize = options.minBlockSize;
+    tiledOptions.tileSize = tileSize;
+    tiledOptions.threadCount = options.threadCount;
+    
+    auto startTime = chrono::high_resolution_clock::now();
+    TiledResult result;
+    bool success = compressTiled(inputPath, options.outputPath, tiledOptions, result, cout);
+    auto endTime = chrono::high_resolution_clock::now();
+    auto duration = chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count();
+    
+    if (!success) return 1;
+    
+    unsigned long long originalSize = static_cast<unsigned long long>(result.width) * result.height * 3;
+    unsigned long long compressedSize = static_cast<unsigned long long>(result.nodeCount) * calculateCompressedSize(1);
+    
+    cout << "Gambar hasil kompresi berhasil disimpan ke: " << options.outputPath << endl;
     cout << "\n===== STATISTIK KOMPRESI =====" << endl;
     cout << "Waktu eksekusi: " << duration << " ms" << endl;
     cout << "Ukuran gambar sebelum: " << originalSize << " bytes" << endl;
     cout << "Ukuran gambar setelah: " << compressedSize << " bytes" << endl;
-    cout << "Persentase kompresi: " << compressionPercentage << "%" << endl;
-    cout << "Kedalaman pohon: " << maxDepth << endl;
-    cout << "Banyak simpul pada pohon: " << nodeCount << endl;
+    cout << "Persentase kompresi: " << (1.0 - static_cast<double>(compressedSize) / originalSize) * 100.0 << "%" << endl;
+    cout << "Kedalaman pohon: " << result.maxDepth << endl;
+    cout << "Banyak simpul pada pohon: " << result.nodeCount << endl;
+    cout << "Jumlah tile: " << result.tileCount << " (kedalaman tile " << result.tileDepth << ")" << endl;
+    cout << "Puncak memori: " << readPeakMemoryKB() << " KB" << endl;
     
-    // Fungsi membuat GIF
-    if (!gifPath.empty()) {
-        cout << "\nMemulai proses pembuatan GIF..." << endl;
+    return 0;
+}
 
-        string ext = gifPath.substr(gifPath.find_last_of(".") + 1);
-        if (ext != "gif" && ext != "GIF") {
-            cout << "Menambahkan ekstensi .gif ke nama file" << endl;
-            gifPath += ".gif";
+// Mode flag: parameter dibaca dari argumen program, tanpa input interaktif
+static int runWithArguments(int argc, char* argv[], int threadCount) {
+    CompressionOptions options;
+    options.threadCount = threadCount;
+    string inputPath, batchSource, outputDir, reportPath, format = "png";
+    string verifySource, goldenPath, writeGoldenPath;
+    int tileSize = 0;
+    
+    for (int i = 1; i < argc; i++) {
+        string flag = argv[i];
+        
+        if (flag == "-h" || flag == "--help") {
+            printUsage(argv[0]);
+            return 0;
         }
-
-        std::replace(gifPath.begin(), gifPath.end(), '\\', '/');
-
-        // Untuk Windows
-        #ifdef _WIN32
-        if (system("where magick > nul 2>&1") == 0) {
-            cout << "Menggunakan ImageMagick versi 7+..." << endl;
-            if (saveGIF(image, root, gifPath, true)) {
-                cout << "GIF berhasil disimpan ke: " << gifPath << endl;
-            } else {
-                cout << "Gagal menyimpan GIF dengan ImageMagick 7+." << endl;
-            }
-        } else if (system("where convert > nul 2>&1") == 0) {
-            cout << "Menggunakan ImageMagick legacy command..." << endl;
-            if (saveGIF(image, root, gifPath, false)) {
-                cout << "GIF berhasil disimpan ke: " << gifPath << endl;
-            } else {
-                cout << "Gagal menyimpan GIF dengan ImageMagick legacy command." << endl;
-            }
+        if (flag == "--progressive") {
+            options.progressive = true;
+            continue;
+        }
+        
+        // Semua flag lain membutuhkan nilai
+        if (i + 1 >= argc) {
+            cout << "Flag " << flag << " membutuhkan nilai" << endl;
+            return 2;
+        }
+        string value = argv[++i];
+        double number = 0;
+        long long integer = 0;
+        
+        if (flag == "-i" || flag == "--input") {
+            inputPath = value;
+        } else if (flag == "-o" || flag == "--output") {
+            options.outputPath = value;
+        } else if (flag == "--gif") {
+            options.gifPath = value;
+        } else if (flag == "--batch") {
+            batchSource = value;
+        } else if (flag == "--verify") {
+            verifySource = value;
+        } else if (flag == "--golden") {
+            goldenPath = value;
+        } else if (flag == "--write-golden") {
+            writeGoldenPath = value;
+        } else if (flag == "--report") {
+            reportPath = value;
+        } else if (flag == "--output-dir") {
+            outputDir = value;
+        } else if (flag == "--format") {
+            format = value;
+            if (!format.empty() && format[0] == '.') format.erase(0, 1);
+        } else if ((flag == "-m" || flag == "--method") && parseInteger(value, integer)) {
+            options.method = static_cast<int>(integer);
+        } else if ((flag == "-t" || flag == "--threshold") && parseNumber(value, number)) {
+            options.threshold = number;
+        } else if ((flag == "-b" || flag == "--min-block") && parseInteger(value, integer)) {
+            options.minBlockSize = static_cast<int>(integer);
+        } else if (flag == "--target" && parseNumber(value, number)) {
+            options.targetCompression = number;
+        } else if (flag == "--max-bytes" && parseInteger(value, integer) && integer >= 0) {
+            options.maxCompressedSize = static_cast<unsigned long long>(integer);
+        } else if (flag == "--tile" && parseInteger(value, integer) && integer > 0 && integer <= 1 << 30) {
+            tileSize = static_cast<int>(integer);
+        } else if ((flag == "-j" || flag == "--threads") && parseInteger(value, integer) && integer > 0) {
+            options.threadCount = static_cast<int>(integer);
         } else {
-            cout << "ImageMagick tidak ditemukan. Pastikan ImageMagick terinstal pada sistem Anda." << endl;
-            cout << "Anda dapat mengunduh ImageMagick dari: https://imagemagick.org/script/download.php" << endl;
-            cout << "Dan pastikan untuk mencentang 'Add application directory to your system path' saat instalasi." << endl;
-        }
-        #else
-        // Pendekatan standard untuk Linux/Mac
-        if (saveGIF(image, root, gifPath, false)) {
-            cout << "GIF berhasil disimpan ke: " << gifPath << endl;
+            cout << "Flag atau nilai tidak valid: " << flag << " " << value << endl;
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    
+    if (!verifySource.empty()) {
+        return runVerify(verifySource, goldenPath, writeGoldenPath, options.threadCount);
+    }
+    
+    validateOptions(options, cout);
+    
+    if (!batchSource.empty()) {
+        if (outputDir.empty()) {
+            cout << "Mode batch membutuhkan --output-dir" << endl;
+            return 2;
+        }
+        if (!options.gifPath.empty()) {
+            cout << "Opsi --gif diabaikan pada mode batch" << endl;
+            options.gifPath.clear();
+        }
+        return runBatch(batchSource, outputDir, format, options, reportPath);
+    }
+    
+    if (inputPath.empty() || options.outputPath.empty()) {
+        cout << "Flag --input dan --output wajib diisi" << endl;
+        printUsage(argv[0]);
+        return 2;
+    }
+    
+    if (hasExtension(inputPath, "qtc")) {
+        return decodeQTCFile(inputPath, options.outputPath);
+    }
+    
+    if (tileSize > 0) {
+        return runTiled(inputPath, options, tileSize);
+    }
+    
+    CompressionMetrics metrics;
+    bool success = compressImageFile(inputPath, options, cout, metrics);
+    
+    if (!reportPath.empty()) {
+        if (saveMetricsJSON(vector<CompressionMetrics>(1, metrics), reportPath)) {
+            cout << "Laporan metrik disimpan ke: " << reportPath << endl;
         } else {
-            cout << "Gagal menyimpan GIF. Pastikan ImageMagick terinstal pada sistem Anda." << endl;
-            cout << "Anda dapat mengunduh ImageMagick dari: https://imagemagick.org/script/download.php" << endl;
+            cout << "Gagal menyimpan laporan metrik ke " << reportPath << endl;
+            return 1;
         }
-        #endif
     }
+    return success ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    FreeImage_Initialise();
     
-    FreeImage_Unload(image);
-    FreeImage_Unload(outputImage);
-    delete root;
+    FreeImage_SetOutputMessage([](FREE_IMAGE_FORMAT fif, const char *message) {
+        cout << "FreeImage Error";
+        if (fif != FIF_UNKNOWN) {
+            cout << " (" << FreeImage_GetFormatFromFIF(fif) << ")";
+        }
+        cout << ": " << message << endl;
+    });
     
-    FreeImage_DeInitialise();
+    // Bangun quadtree (dan GIF) memakai semua core yang tersedia
+    int threadCount = static_cast<int>(thread::hardware_concurrency());
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
     
-    return 0;
-}
\ No newline at end of file
+    // Tanpa argumen program berjalan interaktif seperti biasa
+    int status = argc > 1 ? runWithArguments(argc, argv, threadCount) : runInteractive(threadCount);
+    
+    FreeImage_DeInitialise();
+    return status;
+}
@@ -0,0 +1,99 @@
+// windows.h di-include sebelum FreeImage.h agar tipe BYTE/BOOL diambil dari Windows
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mapped_file.h"
+
+#ifdef _WIN32
+
+bool mapFile(const std::string& path, MappedFile& file) {
+    file.data = nullptr;
+    file.size = 0;
+    file.fileHandle = nullptr;
+    file.mappingHandle = nullptr;
+    
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(handle);
+        return false;
+    }
+    
+    HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(handle);
+        return false;
+    }
+    
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(handle);
+        return false;
+    }
+    
+    file.data = static_cast<const BYTE*>(view);
+    file.size = static_cast<size_t>(fileSize.QuadPart);
+    file.fileHandle = handle;
+    file.mappingHandle = mapping;
+    return true;
+}
+
+void unmapFile(MappedFile& file) {
+    if (file.data) UnmapViewOfFile(file.data);
+    if (file.mappingHandle) CloseHandle(static_cast<HANDLE>(file.mappingHandle));
+    if (file.fileHandle) CloseHandle(static_cast<HANDLE>(file.fileHandle));
+    
+    file.data = nullptr;
+    file.size = 0;
+    file.fileHandle = nullptr;
+    file.mappingHandle = nullptr;
+}
+
+#else
+
+bool mapFile(const std::string& path, MappedFile& file) {
+    file.data = nullptr;
+    file.size = 0;
+    
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) return false;
+    
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size <= 0) {
+        close(descriptor);
+        return false;
+    }
+    
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    // Mapping tetap berlaku setelah descriptor ditutup
+    close(descriptor);
+    if (view == MAP_FAILED) return false;
+    
+    // File dibaca berurutan dari awal hingga akhir
+    madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+    
+    file.data = static_cast<const BYTE*>(view);
+    file.size = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void unmapFile(MappedFile& file) {
+    if (file.data) {
+        munmap(const_cast<BYTE*>(file.data), file.size);
+    }
+    
+    file.data = nullptr;
+    file.size = 0;
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include "FreeImage.h"
+
+// File yang dipetakan ke memori secara read-only (mmap / CreateFileMapping),
+// isinya dibaca langsung dari page cache tanpa disalin ke buffer
+struct MappedFile {
+    const BYTE* data;
+    size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
+
+// Fungsi untuk memetakan dan melepas file
+bool mapFile(const std::string& path, MappedFile& file);
+void unmapFile(MappedFile& file);
+
+#endif
@@ -0,0 +1,251 @@
+// windows.h di-include sebelum FreeImage.h agar tipe BYTE/BOOL diambil dari Windows.
+// PSAPI versi 2 memetakan GetProcessMemoryInfo ke kernel32 sehingga tidak perlu -lpsapi.
+#ifdef _WIN32
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#elif !defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+#include "metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+// Fungsi untuk membaca puncak resident memory proses dalam KB
+long long readPeakMemoryKB() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return -1;
+    return static_cast<long long>(counters.PeakWorkingSetSize / 1024);
+#elif defined(__linux__)
+    FILE* status = fopen("/proc/self/status", "r");
+    if (!status) return -1;
+    
+    long long peak = -1;
+    char line[256];
+    while (fgets(line, sizeof(line), status)) {
+        if (strncmp(line, "VmHWM:", 6) == 0) {
+            peak = atoll(line + 6);
+            break;
+        }
+    }
+    fclose(status);
+    return peak;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef __APPLE__
+    return static_cast<long long>(usage.ru_maxrss / 1024);  // macOS melaporkan dalam bytes
+#else
+    return static_cast<long long>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+// Fungsi untuk me-reset puncak resident memory ke pemakaian saat ini. Hanya didukung
+// Linux (clear_refs mode 5); di sistem lain puncak tetap dihitung sejak proses dimulai.
+bool resetPeakMemory() {
+#if defined(__linux__)
+    FILE* clearRefs = fopen("/proc/self/clear_refs", "w");
+    if (!clearRefs) return false;
+    
+    bool success = fputs("5", clearRefs) >= 0;
+    success = (fclose(clearRefs) == 0) && success;
+    return success;
+#else
+    return false;
+#endif
+}
+
+void resetCompressionMetrics(CompressionMetrics& metrics) {
+    metrics = CompressionMetrics();
+    metrics.success = false;
+    metrics.width = metrics.height = 0;
+    metrics.method = 0;
+    metrics.threshold = 0;
+    metrics.minBlockSize = 0;
+    metrics.threadCount = 1;
+    metrics.duration = 0;
+    metrics.nodeCount = metrics.leafCount = metrics.maxDepth = 0;
+    metrics.qtcBytes = 0;
+    metrics.compressionPercentage = 0;
+    metrics.buildPixels = metrics.drawPixels = 0;
+    metrics.phasePeakMemory = false;
+}
+
+void startPhase(PhaseClock& clock, bool resetPeak) {
+    clock.resetPeak = resetPeak && resetPeakMemory();
+    clock.start = std::chrono::steady_clock::now();
+}
+
+void finishPhase(CompressionMetrics& metrics, const char* name, const PhaseClock& clock) {
+    auto end = std::chrono::steady_clock::now();
+    
+    PhaseMetrics phase;
+    phase.name = name;
+    phase.milliseconds = std::chrono::duration<double, std::milli>(end - clock.start).count();
+    phase.peakMemoryKB = readPeakMemoryKB();
+    metrics.phases.push_back(phase);
+    
+    // Laporan hanya dianggap per tahap jika semua tahap berhasil me-reset puncak memori
+    metrics.phasePeakMemory = (metrics.phases.size() == 1 || metrics.phasePeakMemory) && clock.resetPeak;
+}
+
+// Fungsi untuk mengisi jumlah node, daun dan pixel per kedalaman. Anak selalu disimpan
+// setelah induknya sehingga kedalaman cukup dihitung dalam satu kali iterasi array.
+void collectDepthMetrics(const QuadTree& tree, CompressionMetrics& metrics) {
+    std::vector<int> depths(tree.nodes.size(), 0);
+    
+    metrics.depths.clear();
+    metrics.nodeCount = static_cast<int>(tree.nodes.size());
+    metrics.leafCount = 0;
+    metrics.maxDepth = 0;
+    
+    for (size_t i = 0; i < tree.nodes.size(); i++) {
+        const QuadTreeNode& node = tree.nodes[i];
+        int depth = depths[i];
+        
+        if (static_cast<int>(metrics.depths.size()) <= depth) {
+            DepthMetrics empty = {0, 0, 0};
+            metrics.depths.resize(depth + 1, empty);
+        }
+        
+        DepthMetrics& level = metrics.depths[depth];
+        level.nodes++;
+        level.pixels += static_cast<unsigned long long>(node.width) * node.height;
+        metrics.maxDepth = std::max(metrics.maxDepth, depth);
+        
+        if (node.isLeaf()) {
+            level.leaves++;
+            metrics.leafCount++;
+            continue;
+        }
+        
+        for (int quadrant = 0; quadrant < 4; quadrant++) {
+            depths[node.firstChild + quadrant] = depth + 1;
+        }
+    }
+}
+
+// Fungsi untuk menghitung total luas semua node: setiap node dievaluasi fungsi error sekali
+unsigned long long sumQuadTreeArea(const QuadTree& tree) {
+    unsigned long long area = 0;
+    for (const QuadTreeNode& node : tree.nodes) {
+        area += static_cast<unsigned long long>(node.width) * node.height;
+    }
+    return area;
+}
+
+// ===== Penulisan JSON =====
+
+static void writeJSONString(std::ostream& output, const std::string& text) {
+    output << '"';
+    for (unsigned char c : text) {
+        switch (c) {
+            case '"':  output << "\\\""; break;
+            case '\\': output << "\\\\"; break;
+            case '\n': output << "\\n"; break;
+            case '\r': output << "\\r"; break;
+            case '\t': output << "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    output << escaped;
+                } else {
+                    output << c;
+                }
+        }
+    }
+    output << '"';
+}
+
+// JSON tidak mengenal NaN dan infinity
+static void writeJSONNumber(std::ostream& output, double value) {
+    if (std::isfinite(value)) {
+        output << value;
+    } else {
+        output << "null";
+    }
+}
+
+static void writeCompressionMetrics(std::ostream& output, const CompressionMetrics& metrics) {
+    output << "    {\n";
+    output << "      \"input\": "; writeJSONString(output, metrics.inputPath); output << ",\n";
+    output << "      \"output\": "; writeJSONString(output, metrics.outputPath); output << ",\n";
+    output << "      \"success\": " << (metrics.success ? "true" : "false") << ",\n";
+    output << "      \"width\": " << metrics.width << ",\n";
+    output << "      \"height\": " << metrics.height << ",\n";
+    output << "      \"method\": " << metrics.method << ",\n";
+    output << "      \"threshold\": "; writeJSONNumber(output, metrics.threshold); output << ",\n";
+    output << "      \"minBlockSize\": " << metrics.minBlockSize << ",\n";
+    output << "      \"threads\": " << metrics.threadCount << ",\n";
+    output << "      \"durationMs\": " << metrics.duration << ",\n";
+    output << "      \"nodes\": " << metrics.nodeCount << ",\n";
+    output << "      \"leaves\": " << metrics.leafCount << ",\n";
+    output << "      \"maxDepth\": " << metrics.maxDepth << ",\n";
+    output << "      \"qtcBytes\": " << metrics.qtcBytes << ",\n";
+    output << "      \"compressionPercentage\": "; writeJSONNumber(output, metrics.compressionPercentage); output << ",\n";
+    output << "      \"pixelsTouched\": {\"build\": " << metrics.buildPixels
+           << ", \"draw\": " << metrics.drawPixels << "},\n";
+    output << "      \"peakMemoryScope\": \"" << (metrics.phasePeakMemory ? "phase" : "process") << "\",\n";
+    
+    output << "      \"phases\": [";
+    for (size_t i = 0; i < metrics.phases.size(); i++) {
+        const PhaseMetrics& phase = metrics.phases[i];
+        output << (i ? ",\n" : "\n") << "        {\"name\": ";
+        writeJSONString(output, phase.name);
+        output << ", \"ms\": " << std::fixed << std::setprecision(3) << phase.milliseconds
+               << std::defaultfloat << std::setprecision(6)
+               << ", \"peakMemoryKB\": " << phase.peakMemoryKB << "}";
+    }
+    output << (metrics.phases.empty() ? "],\n" : "\n      ],\n");
+    
+    output << "      \"depths\": [";
+    for (size_t depth = 0; depth < metrics.depths.size(); depth++) {
+        const DepthMetrics& level = metrics.depths[depth];
+        output << (depth ? ",\n" : "\n") << "        {\"depth\": " << depth << ", \"nodes\": " << level.nodes
+               << ", \"leaves\": " << level.leaves << ", \"pixels\": " << level.pixels << "}";
+    }
+    output << (metrics.depths.empty() ? "]\n" : "\n      ]\n");
+    output << "    }";
+}
+
+// Fungsi untuk menulis laporan semua gambar. Nama field dan urutannya tetap agar laporan
+// antar build bisa dibandingkan langsung.
+void writeMetricsJSON(const std::vector<CompressionMetrics>& reports, std::ostream& output) {
+    // Setelah puncak memori di-reset, VmHWM hanya mencakup tahap terakhir
+    long long processPeak = readPeakMemoryKB();
+    for (const CompressionMetrics& metrics : reports) {
+        for (const PhaseMetrics& phase : metrics.phases) {
+            processPeak = std::max(processPeak, phase.peakMemoryKB);
+        }
+    }
+    
+    output << std::setprecision(6);
+    output << "{\n";
+    output << "  \"format\": \"quadtree-metrics\",\n";
+    output << "  \"version\": 1,\n";
+    output << "  \"processPeakMemoryKB\": " << processPeak << ",\n";
+    output << "  \"images\": [";
+    for (size_t i = 0; i < reports.size(); i++) {
+        output << (i ? ",\n" : "\n");
+        writeCompressionMetrics(output, reports[i]);
+    }
+    output << (reports.empty() ? "]\n" : "\n  ]\n");
+    output << "}\n";
+}
+
+bool saveMetricsJSON(const std::vector<CompressionMetrics>& reports, const std::string& path) {
+    std::ofstream file(path.c_str());
+    if (!file) return false;
+    
+    writeMetricsJSON(reports, file);
+    return static_cast<bool>(file);
+}
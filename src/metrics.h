@@ -0,0 +1,72 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "quadtree.h"
+
+// Pengukuran satu tahap pemrosesan (decode, build, draw, ...)
+struct PhaseMetrics {
+    std::string name;
+    double milliseconds;
+    long long peakMemoryKB;     // Puncak resident memory selama tahap, -1 jika tidak tersedia
+};
+
+// Jumlah node, daun dan pixel yang dicakup node pada satu kedalaman pohon
+struct DepthMetrics {
+    int nodes;
+    int leaves;
+    unsigned long long pixels;
+};
+
+// Laporan lengkap kompresi satu gambar, ditulis sebagai JSON
+struct CompressionMetrics {
+    std::string inputPath, outputPath;
+    bool success;
+    int width, height;
+    int method;
+    double threshold;
+    int minBlockSize;
+    int threadCount;
+    
+    long long duration;                 // Waktu eksekusi (ms) yang ditampilkan pada statistik
+    int nodeCount, leafCount, maxDepth;
+    unsigned long long qtcBytes;
+    double compressionPercentage;
+    
+    unsigned long long buildPixels;     // Pixel blok yang dievaluasi fungsi error saat membangun pohon
+    unsigned long long drawPixels;      // Pixel kanvas output yang ditulis saat menggambar
+    
+    bool phasePeakMemory;               // true jika puncak memori di-reset di awal setiap tahap
+    std::vector<PhaseMetrics> phases;
+    std::vector<DepthMetrics> depths;
+};
+
+// Stopwatch satu tahap. Jika resetPeak true, puncak memori proses di-reset saat tahap dimulai
+// sehingga puncak yang tercatat hanya milik tahap tersebut (hanya aman jika satu gambar
+// diproses pada satu waktu).
+struct PhaseClock {
+    std::chrono::steady_clock::time_point start;
+    bool resetPeak;
+};
+
+// Fungsi untuk membaca dan me-reset puncak resident memory proses (VmHWM pada Linux)
+long long readPeakMemoryKB();
+bool resetPeakMemory();
+
+// Fungsi untuk mencatat tahap: startPhase di awal, finishPhase menambahkan hasilnya ke laporan
+void resetCompressionMetrics(CompressionMetrics& metrics);
+void startPhase(PhaseClock& clock, bool resetPeak);
+void finishPhase(CompressionMetrics& metrics, const char* name, const PhaseClock& clock);
+
+// Fungsi untuk mengisi statistik per kedalaman dan menghitung total luas semua node
+void collectDepthMetrics(const QuadTree& tree, CompressionMetrics& metrics);
+unsigned long long sumQuadTreeArea(const QuadTree& tree);
+
+// Fungsi untuk menulis laporan sebagai JSON
+void writeMetricsJSON(const std::vector<CompressionMetrics>& reports, std::ostream& output);
+bool saveMetricsJSON(const std::vector<CompressionMetrics>& reports, const std::string& path);
+
+#endif
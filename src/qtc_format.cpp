@@ -0,0 +1,925 @@
+#include "qtc_format.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <queue>
+#include <utility>
+
+static const BYTE QTC_MAGIC[4] = {'Q', 'T', 'C', '1'};
+static const int QTC_VERSION = 1;
+
+// ===== Bit stream (bit paling signifikan lebih dulu) =====
+
+struct BitWriter {
+    std::vector<BYTE>& output;
+    unsigned int buffer;
+    int bitCount;
+    
+    explicit BitWriter(std::vector<BYTE>& output) : output(output), buffer(0), bitCount(0) {}
+    
+    void write(unsigned int code, int length) {
+        for (int i = length - 1; i >= 0; i--) {
+            buffer = (buffer << 1) | ((code >> i) & 1);
+            if (++bitCount == 8) {
+                output.push_back(static_cast<BYTE>(buffer));
+                buffer = 0;
+                bitCount = 0;
+            }
+        }
+    }
+    
+    void flush() {
+        if (bitCount > 0) {
+            output.push_back(static_cast<BYTE>(buffer << (8 - bitCount)));
+            buffer = 0;
+            bitCount = 0;
+        }
+    }
+};
+
+struct BitReader {
+    const BYTE* data;
+    size_t size;
+    size_t bytePosition;
+    int bitPosition;
+    bool overrun;
+    
+    BitReader(const BYTE* data, size_t size) : data(data), size(size), bytePosition(0), bitPosition(0), overrun(false) {}
+    
+    // Membaca satu bit, bit 0 dikembalikan dan overrun ditandai jika data sudah habis
+    int readBit() {
+        if (bytePosition >= size) {
+            overrun = true;
+            return 0;
+        }
+        
+        int bit = (data[bytePosition] >> (7 - bitPosition)) & 1;
+        if (++bitPosition == 8) {
+            bitPosition = 0;
+            bytePosition++;
+        }
+        return bit;
+    }
+};
+
+// ===== Huffman kanonik =====
+
+// Fungsi untuk menghitung panjang kode Huffman dari frekuensi simbol. Jika ada kode yang
+// lebih panjang dari QTC_MAX_CODE_LENGTH, frekuensi dibagi dua lalu pohon dibangun ulang.
+static void buildCodeLengths(const unsigned long long frequency[256], BYTE lengths[256]) {
+    std::vector<unsigned long long> weights(frequency, frequency + 256);
+    
+    while (true) {
+        std::fill(lengths, lengths + 256, 0);
+        
+        // Node 0..255 adalah simbol, node gabungan ditambahkan setelahnya
+        std::vector<int> parent(256, -1);
+        typedef std::pair<unsigned long long, int> HeapEntry;
+        std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+        
+        for (int symbol = 0; symbol < 256; symbol++) {
+            if (weights[symbol] > 0) {
+                heap.push(HeapEntry(weights[symbol], symbol));
+            }
+        }
+        
+        if (heap.empty()) return;
+        if (heap.size() == 1) {
+            lengths[heap.top().second] = 1;
+            return;
+        }
+        
+        while (heap.size() > 1) {
+            HeapEntry a = heap.top();
+            heap.pop();
+            HeapEntry b = heap.top();
+            heap.pop();
+            
+            int merged = static_cast<int>(parent.size());
+            parent.push_back(-1);
+            parent[a.second] = merged;
+            parent[b.second] = merged;
+            heap.push(HeapEntry(a.first + b.first, merged));
+        }
+        
+        int maxLength = 0;
+        for (int symbol = 0; symbol < 256; symbol++) {
+            if (weights[symbol] == 0) continue;
+            
+            int length = 0;
+            for (int node = symbol; parent[node] >= 0; node = parent[node]) {
+                length++;
+            }
+            lengths[symbol] = static_cast<BYTE>(std::min(length, 255));
+            maxLength = std::max(maxLength, length);
+        }
+        
+        if (maxLength <= QTC_MAX_CODE_LENGTH) return;
+        
+        for (int symbol = 0; symbol < 256; symbol++) {
+            if (weights[symbol] > 0) {
+                weights[symbol] = (weights[symbol] + 1) / 2;
+            }
+        }
+    }
+}
+
+// Fungsi untuk memberi kode kanonik: kode dengan panjang sama berurutan sesuai nilai simbol
+static void buildCanonicalCodes(const BYTE lengths[256], unsigned int codes[256]) {
+    int lengthCount[QTC_MAX_CODE_LENGTH + 1] = {0};
+    for (int symbol = 0; symbol < 256; symbol++) {
+        lengthCount[lengths[symbol]]++;
+    }
+    lengthCount[0] = 0;
+    
+    unsigned int nextCode[QTC_MAX_CODE_LENGTH + 1] = {0};
+    unsigned int code = 0;
+    for (int length = 1; length <= QTC_MAX_CODE_LENGTH; length++) {
+        code = (code + lengthCount[length - 1]) << 1;
+        nextCode[length] = code;
+    }
+    
+    for (int symbol = 0; symbol < 256; symbol++) {
+        codes[symbol] = lengths[symbol] > 0 ? nextCode[lengths[symbol]]++ : 0;
+    }
+}
+
+// Tabel decoder Huffman kanonik: jumlah kode per panjang dan simbol terurut per panjang
+struct HuffmanDecoder {
+    int lengthCount[QTC_MAX_CODE_LENGTH + 1];
+    int symbols[256];
+};
+
+static bool buildHuffmanDecoder(const BYTE lengths[256], HuffmanDecoder& decoder) {
+    std::fill(decoder.lengthCount, decoder.lengthCount + QTC_MAX_CODE_LENGTH + 1, 0);
+    for (int symbol = 0; symbol < 256; symbol++) {
+        if (lengths[symbol] > QTC_MAX_CODE_LENGTH) return false;
+        decoder.lengthCount[lengths[symbol]]++;
+    }
+    decoder.lengthCount[0] = 0;
+    
+    // Tolak tabel yang kodenya melebihi ruang kode (tidak mungkin dari encoder yang valid)
+    int remaining = 1;
+    int used = 0;
+    for (int length = 1; length <= QTC_MAX_CODE_LENGTH; length++) {
+        remaining = (remaining << 1) - decoder.lengthCount[length];
+        used += decoder.lengthCount[length];
+        if (remaining < 0) return false;
+    }
+    if (used == 0) return false;
+    
+    int offsets[QTC_MAX_CODE_LENGTH + 2] = {0};
+    for (int length = 1; length <= QTC_MAX_CODE_LENGTH; length++) {
+        offsets[length + 1] = offsets[length] + decoder.lengthCount[length];
+    }
+    for (int symbol = 0; symbol < 256; symbol++) {
+        if (lengths[symbol] > 0) {
+            decoder.symbols[offsets[lengths[symbol]]++] = symbol;
+        }
+    }
+    
+    return true;
+}
+
+// Fungsi untuk membaca satu simbol, -1 jika kode tidak valid
+static int decodeSymbol(BitReader& reader, const HuffmanDecoder& decoder) {
+    int code = 0, first = 0, index = 0;
+    
+    for (int length = 1; length <= QTC_MAX_CODE_LENGTH; length++) {
+        code |= reader.readBit();
+        int count = decoder.lengthCount[length];
+        if (code - first < count) {
+            return decoder.symbols[index + code - first];
+        }
+        
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    
+    return -1;
+}
+
+// ===== Header =====
+
+static void writeU32(std::vector<BYTE>& output, unsigned int value) {
+    for (int i = 0; i < 4; i++) {
+        output.push_back(static_cast<BYTE>(value >> (8 * i)));
+    }
+}
+
+static unsigned int readU32(const BYTE* data) {
+    return static_cast<unsigned int>(data[0]) | (static_cast<unsigned int>(data[1]) << 8) |
+           (static_cast<unsigned int>(data[2]) << 16) | (static_cast<unsigned int>(data[3]) << 24);
+}
+
+bool readQTCHeader(const BYTE* data, size_t size, QTCHeader& header) {
+    if (size < static_cast<size_t>(QTC_HEADER_SIZE + QTC_CODE_TABLE_SIZE)) return false;
+    if (!std::equal(QTC_MAGIC, QTC_MAGIC + 4, data)) return false;
+    
+    header.version = data[4];
+    header.order = data[5];
+    
+    unsigned int fields[6];
+    for (int i = 0; i < 6; i++) {
+        fields[i] = readU32(data + 8 + 4 * i);
+        if (fields[i] > 0x7FFFFFFFu) return false;
+    }
+    
+    header.width = static_cast<int>(fields[0]);
+    header.height = static_cast<int>(fields[1]);
+    header.minBlockSize = static_cast<int>(fields[2]);
+    header.nodeCount = static_cast<int>(fields[3]);
+    header.leafCount = static_cast<int>(fields[4]);
+    header.splitBytes = static_cast<int>(fields[5]);
+    
+    if (header.version != QTC_VERSION) return false;
+    if (header.order != QTC_ORDER_PREORDER && header.order != QTC_ORDER_LEVEL) return false;
+    if (header.width <= 0 || header.height <= 0 || header.minBlockSize <= 0) return false;
+    
+    // Setiap pembagian menambah 4 node dan 3 daun, dan setiap pembagian butuh satu bit
+    long long splitCount = (header.nodeCount - 1) / 4;
+    if (header.nodeCount <= 0 || (header.nodeCount - 1) % 4 != 0) return false;
+    if (header.leafCount != 3 * splitCount + 1) return false;
+    if (header.order == QTC_ORDER_PREORDER && splitCount > 8LL * header.splitBytes) return false;
+    if (header.order == QTC_ORDER_LEVEL && header.splitBytes != 0) return false;
+    
+    size_t payload = size - QTC_HEADER_SIZE - QTC_CODE_TABLE_SIZE;
+    return static_cast<size_t>(header.splitBytes) <= payload;
+}
+
+// ===== Encoder =====
+
+// Fungsi untuk menulis header dan tabel panjang kode Huffman ke akhir output
+static void writeHeaderAndTables(const QuadTree& tree, int minBlockSize, int order, int leafCount,
+                                 int splitBytes, const BYTE lengths[3][256], std::vector<BYTE>& output) {
+    const QuadTreeNode& root = tree.root();
+    
+    for (int i = 0; i < 4; i++) {
+        output.push_back(QTC_MAGIC[i]);
+    }
+    output.push_back(static_cast<BYTE>(QTC_VERSION));
+    output.push_back(static_cast<BYTE>(order));
+    output.push_back(0);
+    output.push_back(0);
+    writeU32(output, root.width);
+    writeU32(output, root.height);
+    writeU32(output, minBlockSize);
+    writeU32(output, static_cast<unsigned int>(tree.nodes.size()));
+    writeU32(output, static_cast<unsigned int>(leafCount));
+    writeU32(output, static_cast<unsigned int>(splitBytes));
+    
+    for (int c = 0; c < 3; c++) {
+        for (int symbol = 0; symbol < 256; symbol += 2) {
+            output.push_back(static_cast<BYTE>((lengths[c][symbol] << 4) | lengths[c][symbol + 1]));
+        }
+    }
+}
+
+// Rekursi pre-order: tulis bit pembagian setiap node dan kumpulkan warna daun
+static bool collectPreOrder(const QuadTree& tree, int index, int minBlockSize,
+                            BitWriter& splits, std::vector<RGBQUAD>& leafColors) {
+    const QuadTreeNode& node = tree.nodes[index];
+    
+    if (canSplitQuadTreeBlock(node.width, node.height, minBlockSize)) {
+        splits.write(node.isLeaf() ? 0 : 1, 1);
+    } else if (!node.isLeaf()) {
+        // Tree dibagi lebih kecil dari ukuran blok minimum yang diberikan
+        return false;
+    }
+    
+    if (node.isLeaf()) {
+        leafColors.push_back(node.avgColor);
+        return true;
+    }
+    
+    for (int quadrant = 0; quadrant < 4; quadrant++) {
+        if (!collectPreOrder(tree, node.firstChild + quadrant, minBlockSize, splits, leafColors)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Fungsi untuk meng-encode quadtree ke format .qtc
+bool encodeQTC(const QuadTree& tree, int minBlockSize, std::vector<BYTE>& output) {
+    if (tree.nodes.empty() || minBlockSize <= 0) return false;
+    
+    std::vector<BYTE> splitBits;
+    std::vector<RGBQUAD> leafColors;
+    BitWriter splitWriter(splitBits);
+    
+    if (!collectPreOrder(tree, 0, minBlockSize, splitWriter, leafColors)) return false;
+    splitWriter.flush();
+    
+    // Warna daun diubah menjadi selisih terhadap daun sebelumnya, lalu dihitung frekuensinya
+    std::vector<BYTE> deltas(leafColors.size() * 3);
+    unsigned long long frequency[3][256] = {{0}};
+    RGBQUAD previous = {0, 0, 0, 0};
+    
+    for (size_t i = 0; i < leafColors.size(); i++) {
+        const RGBQUAD& color = leafColors[i];
+        deltas[3 * i + 0] = static_cast<BYTE>(color.rgbRed - previous.rgbRed);
+        deltas[3 * i + 1] = static_cast<BYTE>(color.rgbGreen - previous.rgbGreen);
+        deltas[3 * i + 2] = static_cast<BYTE>(color.rgbBlue - previous.rgbBlue);
+        
+        for (int c = 0; c < 3; c++) {
+            frequency[c][deltas[3 * i + c]]++;
+        }
+        previous = color;
+    }
+    
+    BYTE lengths[3][256];
+    unsigned int codes[3][256];
+    for (int c = 0; c < 3; c++) {
+        buildCodeLengths(frequency[c], lengths[c]);
+        buildCanonicalCodes(lengths[c], codes[c]);
+    }
+    
+    output.clear();
+    output.reserve(QTC_HEADER_SIZE + QTC_CODE_TABLE_SIZE + splitBits.size() + deltas.size());
+    writeHeaderAndTables(tree, minBlockSize, QTC_ORDER_PREORDER, static_cast<int>(leafColors.size()),
+                         static_cast<int>(splitBits.size()), lengths, output);
+    
+    output.insert(output.end(), splitBits.begin(), splitBits.end());
+    
+    BitWriter colorWriter(output);
+    for (size_t i = 0; i < deltas.size(); i++) {
+        int c = static_cast<int>(i % 3);
+        colorWriter.write(codes[c][deltas[i]], lengths[c][deltas[i]]);
+    }
+    colorWriter.flush();
+    
+    return true;
+}
+
+// ===== Encoder progresif (urutan per kedalaman) =====
+
+// Fungsi untuk menyiapkan encoder progresif dan menulis header serta tabel kode ke output
+bool startQTCStream(const QuadTree& tree, int minBlockSize, QTCStreamEncoder& encoder, std::vector<BYTE>& output) {
+    if (tree.nodes.empty() || minBlockSize <= 0) return false;
+    
+    encoder.deltas.clear();
+    encoder.splits.clear();
+    encoder.deltas.reserve(tree.nodes.size() * 3);
+    encoder.splits.reserve(tree.nodes.size());
+    
+    // Antrian BFS beserta induk tiap node; warna node dikodekan sebagai selisih terhadap induknya
+    std::vector<int> queue(1, 0);
+    std::vector<int> parents(1, -1);
+    queue.reserve(tree.nodes.size());
+    parents.reserve(tree.nodes.size());
+    
+    unsigned long long frequency[3][256] = {{0}};
+    int leafCount = 0;
+    
+    for (size_t i = 0; i < queue.size(); i++) {
+        const QuadTreeNode& node = tree.nodes[queue[i]];
+        RGBQUAD parentColor = {0, 0, 0, 0};
+        if (parents[i] >= 0) parentColor = tree.nodes[parents[i]].avgColor;
+        
+        BYTE delta[3];
+        delta[0] = static_cast<BYTE>(node.avgColor.rgbRed - parentColor.rgbRed);
+        delta[1] = static_cast<BYTE>(node.avgColor.rgbGreen - parentColor.rgbGreen);
+        delta[2] = static_cast<BYTE>(node.avgColor.rgbBlue - parentColor.rgbBlue);
+        for (int c = 0; c < 3; c++) {
+            encoder.deltas.push_back(delta[c]);
+            frequency[c][delta[c]]++;
+        }
+        
+        if (canSplitQuadTreeBlock(node.width, node.height, minBlockSize)) {
+            encoder.splits.push_back(node.isLeaf() ? 0 : 1);
+        } else if (!node.isLeaf()) {
+            return false;
+        } else {
+            encoder.splits.push_back(-1);
+        }
+        
+        if (node.isLeaf()) {
+            leafCount++;
+            continue;
+        }
+        
+        for (int quadrant = 0; quadrant < 4; quadrant++) {
+            queue.push_back(node.firstChild + quadrant);
+            parents.push_back(queue[i]);
+        }
+    }
+    
+    for (int c = 0; c < 3; c++) {
+        buildCodeLengths(frequency[c], encoder.lengths[c]);
+        buildCanonicalCodes(encoder.lengths[c], encoder.codes[c]);
+    }
+    
+    encoder.nextNode = 0;
+    encoder.pendingBits = 0;
+    encoder.pendingCount = 0;
+    
+    writeHeaderAndTables(tree, minBlockSize, QTC_ORDER_LEVEL, leafCount, 0, encoder.lengths, output);
+    return true;
+}
+
+// Fungsi untuk menulis node berikutnya ke output. Bit yang belum genap satu byte disimpan
+// di encoder sampai pemanggilan berikutnya, jadi output selalu berisi byte yang sudah final.
+bool writeQTCStream(QTCStreamEncoder& encoder, std::vector<BYTE>& output, size_t maxBytes) {
+    BitWriter writer(output);
+    writer.buffer = encoder.pendingBits;
+    writer.bitCount = encoder.pendingCount;
+    
+    size_t start = output.size();
+    size_t nodeCount = encoder.splits.size();
+    
+    while (encoder.nextNode < nodeCount && output.size() - start < maxBytes) {
+        size_t i = encoder.nextNode++;
+        for (int c = 0; c < 3; c++) {
+            BYTE delta = encoder.deltas[3 * i + c];
+            writer.write(encoder.codes[c][delta], encoder.lengths[c][delta]);
+        }
+        if (encoder.splits[i] >= 0) {
+            writer.write(encoder.splits[i], 1);
+        }
+    }
+    
+    if (encoder.nextNode == nodeCount) {
+        writer.flush();
+    }
+    
+    encoder.pendingBits = writer.buffer;
+    encoder.pendingCount = writer.bitCount;
+    return encoder.nextNode == nodeCount;
+}
+
+// Fungsi untuk meng-encode quadtree ke format .qtc progresif dalam satu kali panggil
+bool encodeQTCProgressive(const QuadTree& tree, int minBlockSize, std::vector<BYTE>& output) {
+    QTCStreamEncoder encoder;
+    output.clear();
+    if (!startQTCStream(tree, minBlockSize, encoder, output)) return false;
+    
+    writeQTCStream(encoder, output, static_cast<size_t>(-1));
+    return true;
+}
+
+// ===== Decoder =====
+
+// Fungsi untuk membaca panjang kode Huffman satu channel (4 bit per simbol) dari header
+static void readCodeLengths(const BYTE* table, int channel, BYTE lengths[256]) {
+    for (int symbol = 0; symbol < 256; symbol += 2) {
+        lengths[symbol] = table[channel * 128 + symbol / 2] >> 4;
+        lengths[symbol + 1] = table[channel * 128 + symbol / 2] & 0x0F;
+    }
+}
+
+struct QTCDecodeState {
+    const QTCHeader& header;
+    BitReader splits;
+    BitReader colors;
+    HuffmanDecoder decoders[3];
+    RGBQUAD previous;
+    int leafCount;
+    
+    QTCDecodeState(const QTCHeader& header, const BYTE* splitData, size_t splitSize,
+                   const BYTE* colorData, size_t colorSize)
+        : header(header), splits(splitData, splitSize), colors(colorData, colorSize), leafCount(0) {
+        previous = {0, 0, 0, 0};
+    }
+};
+
+// Rekursi pre-order: baca bit pembagian, bagi node atau baca warna daunnya
+static bool decodePreOrder(QuadTree& tree, int index, QTCDecodeState& state) {
+    const QuadTreeNode& node = tree.nodes[index];
+    bool split = false;
+    
+    if (canSplitQuadTreeBlock(node.width, node.height, state.header.minBlockSize)) {
+        split = state.splits.readBit() == 1;
+        if (state.splits.overrun) return false;
+    }
+    
+    if (!split) {
+        int delta[3];
+        for (int c = 0; c < 3; c++) {
+            delta[c] = decodeSymbol(state.colors, state.decoders[c]);
+            if (delta[c] < 0 || state.colors.overrun) return false;
+        }
+        
+        state.previous.rgbRed = static_cast<BYTE>(state.previous.rgbRed + delta[0]);
+        state.previous.rgbGreen = static_cast<BYTE>(state.previous.rgbGreen + delta[1]);
+        state.previous.rgbBlue = static_cast<BYTE>(state.previous.rgbBlue + delta[2]);
+        tree.nodes[index].avgColor = state.previous;
+        
+        return ++state.leafCount <= state.header.leafCount;
+    }
+    
+    if (static_cast<int>(tree.nodes.size()) + 4 > state.header.nodeCount) return false;
+    
+    int first = splitQuadTreeNode(tree, index);
+    for (int quadrant = 0; quadrant < 4; quadrant++) {
+        if (!decodePreOrder(tree, first + quadrant, state)) return false;
+    }
+    return true;
+}
+
+// Fungsi untuk mengisi warna node internal dengan rata-rata anak-anaknya (berbobot luas),
+// agar tree hasil decode juga bisa dirender per kedalaman. Anak selalu berada setelah induknya.
+static void fillInternalColors(QuadTree& tree) {
+    for (int i = static_cast<int>(tree.nodes.size()) - 1; i >= 0; i--) {
+        QuadTreeNode& node = tree.nodes[i];
+        if (node.isLeaf()) continue;
+        
+        unsigned long long sum[3] = {0, 0, 0};
+        unsigned long long area = 0;
+        for (int quadrant = 0; quadrant < 4; quadrant++) {
+            const QuadTreeNode& child = tree.nodes[node.firstChild + quadrant];
+            unsigned long long childArea = static_cast<unsigned long long>(child.width) * child.height;
+            sum[0] += child.avgColor.rgbRed * childArea;
+            sum[1] += child.avgColor.rgbGreen * childArea;
+            sum[2] += child.avgColor.rgbBlue * childArea;
+            area += childArea;
+        }
+        
+        if (area > 0) {
+            node.avgColor.rgbRed = static_cast<BYTE>(sum[0] / area);
+            node.avgColor.rgbGreen = static_cast<BYTE>(sum[1] / area);
+            node.avgColor.rgbBlue = static_cast<BYTE>(sum[2] / area);
+        }
+    }
+}
+
+// Fungsi untuk men-decode buffer .qtc menjadi quadtree
+bool decodeQTC(const BYTE* data, size_t size, QuadTree& tree) {
+    QTCHeader header;
+    if (!readQTCHeader(data, size, header)) return false;
+    
+    if (header.order == QTC_ORDER_LEVEL) {
+        QTCStreamDecoder decoder;
+        resetQTCStreamDecoder(decoder);
+        if (readQTCStream(decoder, data, size) != QTC_STREAM_COMPLETE) {
+            tree.clear();
+            return false;
+        }
+        
+        tree = std::move(decoder.tree);
+        return true;
+    }
+    
+    const BYTE* table = data + QTC_HEADER_SIZE;
+    const BYTE* splitData = table + QTC_CODE_TABLE_SIZE;
+    const BYTE* colorData = splitData + header.splitBytes;
+    size_t colorSize = size - (colorData - data);
+    
+    QTCDecodeState state(header, splitData, header.splitBytes, colorData, colorSize);
+    
+    for (int c = 0; c < 3; c++) {
+        BYTE lengths[256];
+        readCodeLengths(table, c, lengths);
+        if (!buildHuffmanDecoder(lengths, state.decoders[c])) return false;
+    }
+    
+    tree.clear();
+    tree.nodes.reserve(header.nodeCount);
+    addQuadTreeNode(tree, 0, 0, header.width, header.height);
+    
+    if (!decodePreOrder(tree, 0, state) || state.leafCount != header.leafCount ||
+        static_cast<int>(tree.nodes.size()) != header.nodeCount) {
+        tree.clear();
+        return false;
+    }
+    
+    fillInternalColors(tree);
+    return true;
+}
+
+// ===== Decoder progresif =====
+
+void resetQTCStreamDecoder(QTCStreamDecoder& decoder) {
+    decoder.headerRead = false;
+    decoder.tree.clear();
+    decoder.nextNode = 0;
+    decoder.bitPosition = 0;
+}
+
+// Fungsi untuk melanjutkan decode stream progresif. Node hanya diterapkan ke tree jika warna
+// dan bit pembagiannya sudah lengkap; jika data habis di tengah node, posisi dikembalikan ke
+// awal node tersebut dan QTC_STREAM_NEED_MORE dikembalikan.
+QTCStreamStatus readQTCStream(QTCStreamDecoder& decoder, const BYTE* data, size_t size) {
+    const size_t bodyOffset = QTC_HEADER_SIZE + QTC_CODE_TABLE_SIZE;
+    
+    if (!decoder.headerRead) {
+        if (size < bodyOffset) return QTC_STREAM_NEED_MORE;
+        if (!readQTCHeader(data, size, decoder.header) || decoder.header.order != QTC_ORDER_LEVEL) {
+            return QTC_STREAM_ERROR;
+        }
+        
+        for (int c = 0; c < 3; c++) {
+            readCodeLengths(data + QTC_HEADER_SIZE, c, decoder.lengths[c]);
+        }
+        
+        decoder.tree.clear();
+        addQuadTreeNode(decoder.tree, 0, 0, decoder.header.width, decoder.header.height);
+        decoder.nextNode = 0;
+        decoder.bitPosition = 0;
+        decoder.headerRead = true;
+    }
+    
+    HuffmanDecoder decoders[3];
+    for (int c = 0; c < 3; c++) {
+        if (!buildHuffmanDecoder(decoder.lengths[c], decoders[c])) return QTC_STREAM_ERROR;
+    }
+    
+    BitReader reader(data + bodyOffset, size - bodyOffset);
+    reader.bytePosition = static_cast<size_t>(decoder.bitPosition / 8);
+    reader.bitPosition = static_cast<int>(decoder.bitPosition % 8);
+    
+    QuadTree& tree = decoder.tree;
+    
+    // Node dibuat dalam urutan BFS, jadi node berikutnya yang harus dibaca adalah nextNode
+    while (decoder.nextNode < static_cast<int>(tree.nodes.size())) {
+        int delta[3];
+        for (int c = 0; c < 3; c++) {
+            delta[c] = decodeSymbol(reader, decoders[c]);
+            if (reader.overrun) return QTC_STREAM_NEED_MORE;
+            if (delta[c] < 0) return QTC_STREAM_ERROR;
+        }
+        
+        QuadTreeNode& node = tree.nodes[decoder.nextNode];
+        bool split = false;
+        if (canSplitQuadTreeBlock(node.width, node.height, decoder.header.minBlockSize)) {
+            split = reader.readBit() == 1;
+            if (reader.overrun) return QTC_STREAM_NEED_MORE;
+        }
+        
+        // Warna awal node adalah warna induknya, selisihnya sekarang sudah diketahui
+        node.avgColor.rgbRed = static_cast<BYTE>(node.avgColor.rgbRed + delta[0]);
+        node.avgColor.rgbGreen = static_cast<BYTE>(node.avgColor.rgbGreen + delta[1]);
+        node.avgColor.rgbBlue = static_cast<BYTE>(node.avgColor.rgbBlue + delta[2]);
+        
+        if (split) {
+            if (static_cast<int>(tree.nodes.size()) + 4 > decoder.header.nodeCount) return QTC_STREAM_ERROR;
+            
+            int first = splitQuadTreeNode(tree, decoder.nextNode);
+            for (int quadrant = 0; quadrant < 4; quadrant++) {
+                tree.nodes[first + quadrant].avgColor = tree.nodes[decoder.nextNode].avgColor;
+            }
+        }
+        
+        decoder.nextNode++;
+        decoder.bitPosition = 8ULL * reader.bytePosition + reader.bitPosition;
+    }
+    
+    if (static_cast<int>(tree.nodes.size()) != decoder.header.nodeCount) return QTC_STREAM_ERROR;
+    return QTC_STREAM_COMPLETE;
+}
+
+// ===== Render langsung tanpa QuadTreeNode =====
+
+// Bit reader untuk jalur render: bit diambil dari register 64 bit yang diisi ulang per byte
+// hanya saat hampir habis. Byte di luar data dibaca sebagai 0, kelebihannya dicek lewat overrun().
+struct FastBitReader {
+    const BYTE* data;
+    size_t size;
+    size_t position;
+    unsigned long long buffer;
+    int bitCount;
+    unsigned long long consumedBits;
+    
+    FastBitReader(const BYTE* data, size_t size)
+        : data(data), size(size), position(0), buffer(0), bitCount(0), consumedBits(0) {
+        refill();
+    }
+    
+    // Setelah refill, minimal 57 bit tersedia di buffer
+    void refill() {
+        while (bitCount <= 56) {
+            unsigned long long next = position < size ? data[position] : 0;
+            buffer |= next << (56 - bitCount);
+            position++;
+            bitCount += 8;
+        }
+    }
+    
+    unsigned int peek(int count) const {
+        return static_cast<unsigned int>(buffer >> (64 - count));
+    }
+    
+    void consume(int count) {
+        buffer <<= count;
+        bitCount -= count;
+        consumedBits += count;
+    }
+    
+    bool overrun() const {
+        return consumedBits > 8ULL * size;
+    }
+};
+
+// Kode Huffman hingga QTC_FAST_BITS bit di-decode dengan satu lookup tabel,
+// kode yang lebih panjang (jarang muncul) lewat jalur kanonik biasa
+static const int QTC_FAST_BITS = 10;
+
+struct FastHuffmanDecoder {
+    unsigned short entries[1 << QTC_FAST_BITS];  // (simbol << 4) | panjang, 0 untuk kode panjang
+    HuffmanDecoder canonical;
+};
+
+static bool buildFastHuffmanDecoder(const BYTE lengths[256], FastHuffmanDecoder& decoder) {
+    if (!buildHuffmanDecoder(lengths, decoder.canonical)) return false;
+    
+    unsigned int codes[256];
+    buildCanonicalCodes(lengths, codes);
+    
+    std::fill(decoder.entries, decoder.entries + (1 << QTC_FAST_BITS), 0);
+    for (int symbol = 0; symbol < 256; symbol++) {
+        int length = lengths[symbol];
+        if (length == 0 || length > QTC_FAST_BITS) continue;
+        
+        // Semua indeks yang diawali kode ini menunjuk ke simbol yang sama
+        unsigned int first = codes[symbol] << (QTC_FAST_BITS - length);
+        unsigned int count = 1u << (QTC_FAST_BITS - length);
+        for (unsigned int k = 0; k < count; k++) {
+            decoder.entries[first + k] = static_cast<unsigned short>((symbol << 4) | length);
+        }
+    }
+    
+    return true;
+}
+
+static int decodeFastSymbol(FastBitReader& reader, const FastHuffmanDecoder& decoder) {
+    reader.refill();
+    
+    unsigned short entry = decoder.entries[reader.peek(QTC_FAST_BITS)];
+    if (entry != 0) {
+        reader.consume(entry & 0x0F);
+        return entry >> 4;
+    }
+    
+    const HuffmanDecoder& canonical = decoder.canonical;
+    int first = 0, index = 0;
+    
+    for (int length = 1; length <= QTC_MAX_CODE_LENGTH; length++) {
+        int code = static_cast<int>(reader.peek(length));
+        int count = canonical.lengthCount[length];
+        if (code - first < count) {
+            reader.consume(length);
+            return canonical.symbols[index + code - first];
+        }
+        
+        index += count;
+        first = (first + count) << 1;
+    }
+    
+    return -1;
+}
+
+// Fungsi untuk mewarnai blok pada buffer pixel interleaved 3 byte per pixel:
+// baris pertama diisi per pixel, baris berikutnya cukup disalin
+static void fillPixels(BYTE* pixels, int pitch, int x, int y, int width, int height, const BYTE color[3]) {
+    BYTE* firstRow = pixels + static_cast<size_t>(y) * pitch + static_cast<size_t>(x) * 3;
+    
+    for (int i = 0; i < width; i++) {
+        firstRow[3 * i + 0] = color[0];
+        firstRow[3 * i + 1] = color[1];
+        firstRow[3 * i + 2] = color[2];
+    }
+    
+    for (int j = 1; j < height; j++) {
+        memcpy(firstRow + static_cast<size_t>(j) * pitch, firstRow, static_cast<size_t>(width) * 3);
+    }
+}
+
+// Fungsi untuk me-render buffer .qtc langsung ke buffer pixel milik pemanggil. Traversal
+// pre-order sama seperti drawQuadTree, tetapi node hanya hidup sebagai persegi di stack:
+// setiap daun langsung diwarnai begitu warnanya terbaca.
+bool renderQTC(const BYTE* data, size_t size, BYTE* pixels, int pitch, bool bgrOrder) {
+    QTCHeader header;
+    if (!readQTCHeader(data, size, header)) return false;
+    
+    int redOffset = bgrOrder ? 2 : 0;
+    int blueOffset = bgrOrder ? 0 : 2;
+    
+    // Stream progresif butuh seluruh tree sebelum daunnya diketahui, jadi di-decode dulu
+    if (header.order == QTC_ORDER_LEVEL) {
+        QuadTree tree;
+        if (!decodeQTC(data, size, tree)) return false;
+        
+        for (const QuadTreeNode& node : tree.nodes) {
+            if (!node.isLeaf()) continue;
+            
+            BYTE color[3];
+            color[redOffset] = node.avgColor.rgbRed;
+            color[1] = node.avgColor.rgbGreen;
+            color[blueOffset] = node.avgColor.rgbBlue;
+            fillPixels(pixels, pitch, node.x, node.y, node.width, node.height, color);
+        }
+        return true;
+    }
+    
+    const BYTE* table = data + QTC_HEADER_SIZE;
+    const BYTE* splitData = table + QTC_CODE_TABLE_SIZE;
+    const BYTE* colorData = splitData + header.splitBytes;
+    
+    FastHuffmanDecoder decoders[3];
+    for (int c = 0; c < 3; c++) {
+        BYTE lengths[256];
+        readCodeLengths(table, c, lengths);
+        if (!buildFastHuffmanDecoder(lengths, decoders[c])) return false;
+    }
+    
+    FastBitReader splits(splitData, header.splitBytes);
+    FastBitReader colors(colorData, size - (colorData - data));
+    
+    struct Block {
+        int x, y, width, height;
+    };
+    std::vector<Block> stack;
+    stack.reserve(128);
+    stack.push_back({0, 0, header.width, header.height});
+    
+    BYTE previous[3] = {0, 0, 0};
+    int nodeCount = 1;
+    int leafCount = 0;
+    
+    while (!stack.empty()) {
+        Block block = stack.back();
+        stack.pop_back();
+        
+        bool split = false;
+        if (canSplitQuadTreeBlock(block.width, block.height, header.minBlockSize)) {
+            splits.refill();
+            split = splits.peek(1) == 1;
+            splits.consume(1);
+        }
+        
+        if (split) {
+            nodeCount += 4;
+            if (nodeCount > header.nodeCount) return false;
+            
+            // Anak dimasukkan terbalik agar kiri atas diproses lebih dulu (urutan pre-order)
+            int halfWidth = block.width / 2;
+            int halfHeight = block.height / 2;
+            stack.push_back({block.x + halfWidth, block.y + halfHeight, block.width - halfWidth, block.height - halfHeight});
+            stack.push_back({block.x, block.y + halfHeight, halfWidth, block.height - halfHeight});
+            stack.push_back({block.x + halfWidth, block.y, block.width - halfWidth, halfHeight});
+            stack.push_back({block.x, block.y, halfWidth, halfHeight});
+            continue;
+        }
+        
+        for (int c = 0; c < 3; c++) {
+            int delta = decodeFastSymbol(colors, decoders[c]);
+            if (delta < 0) return false;
+            previous[c] = static_cast<BYTE>(previous[c] + delta);
+        }
+        if (++leafCount > header.leafCount) return false;
+        
+        BYTE color[3];
+        color[redOffset] = previous[0];
+        color[1] = previous[1];
+        color[blueOffset] = previous[2];
+        fillPixels(pixels, pitch, block.x, block.y, block.width, block.height, color);
+    }
+    
+    return !splits.overrun() && !colors.overrun() && 
+           nodeCount == header.nodeCount && leafCount == header.leafCount;
+}
+
+// ===== File =====
+
+// Fungsi untuk menyimpan quadtree ke file .qtc
+bool saveQTC(const QuadTree& tree, int minBlockSize, const std::string& path) {
+    std::vector<BYTE> buffer;
+    if (!encodeQTC(tree, minBlockSize, buffer)) {
+        std::cerr << "Error: Quadtree tidak dapat di-encode ke format .qtc" << std::endl;
+        return false;
+    }
+    
+    return saveQTC(buffer, path);
+}
+
+// Fungsi untuk menyimpan buffer .qtc yang sudah di-encode ke file
+bool saveQTC(const std::vector<BYTE>& buffer, const std::string& path) {
+    std::ofstream file(path.c_str(), std::ios::binary);
+    if (!file) {
+        std::cerr << "Error: Gagal membuka file " << path << " untuk ditulis" << std::endl;
+        return false;
+    }
+    
+    file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    return static_cast<bool>(file);
+}
+
+// Fungsi untuk memuat quadtree dari file .qtc
+bool loadQTC(const std::string& path, QuadTree& tree) {
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file) {
+        std::cerr << "Error: Gagal membuka file " << path << std::endl;
+        return false;
+    }
+    
+    std::vector<BYTE> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    
+    if (!decodeQTC(buffer.data(), buffer.size(), tree)) {
+        std::cerr << "Error: File " << path << " bukan file .qtc yang valid" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,99 @@
+#ifndef QTC_FORMAT_H
+#define QTC_FORMAT_H
+
+#include <string>
+#include <vector>
+#include "quadtree.h"
+
+// Format file .qtc untuk menyimpan quadtree hasil kompresi (semua bilangan little-endian):
+//   [0]   "QTC1"
+//   [4]   u8 versi, u8 urutan node (0 = pre-order), u16 cadangan
+//   [8]   u32 lebar, u32 tinggi, u32 ukuran blok minimum
+//   [20]  u32 jumlah node, u32 jumlah daun, u32 panjang bagian bit pembagian (bytes)
+//   [32]  3 x 128 bytes panjang kode Huffman delta R, G, B (4 bit per simbol)
+//   [416] bit pembagian: satu bit per node dalam urutan pre-order. Node yang ukurannya
+//         sudah tidak bisa dibagi tidak diberi bit karena pasti daun. Posisi dan
+//         ukuran node tidak disimpan, semuanya diturunkan dari aturan pembagian.
+//   sisa: warna daun dalam urutan pre-order sebagai selisih (mod 256) terhadap daun
+//         sebelumnya per channel, dikodekan dengan Huffman kanonik (maksimum 15 bit)
+//
+// Urutan progresif (urutan node = 1) memakai header dan tabel kode yang sama dengan panjang
+// bagian bit pembagian 0. Setelah tabel kode, setiap node dalam urutan per kedalaman (BFS)
+// ditulis sebagai warna rata-ratanya (selisih terhadap warna induk, akar terhadap 0) diikuti
+// bit pembagiannya. Karena setiap node membawa warna, potongan awal stream sudah bisa
+// di-decode menjadi gambar utuh yang lebih kasar dan makin halus seiring bertambahnya data.
+const int QTC_HEADER_SIZE = 32;
+const int QTC_CODE_TABLE_SIZE = 3 * 128;
+const int QTC_MAX_CODE_LENGTH = 15;
+const int QTC_ORDER_PREORDER = 0;
+const int QTC_ORDER_LEVEL = 1;
+
+// Informasi header file .qtc
+struct QTCHeader {
+    int version;
+    int order;
+    int width, height;
+    int minBlockSize;
+    int nodeCount;
+    int leafCount;
+    int splitBytes;
+};
+
+// State encoder progresif: seluruh selisih warna dan bit pembagian disiapkan di awal,
+// lalu stream ditulis sepotong demi sepotong
+struct QTCStreamEncoder {
+    std::vector<BYTE> deltas;       // 3 selisih warna per node, urutan BFS
+    std::vector<signed char> splits; // bit pembagian per node, -1 jika node tidak bisa dibagi
+    BYTE lengths[3][256];
+    unsigned int codes[3][256];
+    size_t nextNode;
+    unsigned int pendingBits;
+    int pendingCount;
+};
+
+// State decoder progresif. Tree selalu lengkap: node yang belum terbaca memakai warna
+// induknya, sehingga bisa langsung dirender dengan drawQuadTree / drawQuadTreeRegion.
+struct QTCStreamDecoder {
+    QTCHeader header;
+    bool headerRead;
+    BYTE lengths[3][256];
+    QuadTree tree;
+    int nextNode;
+    unsigned long long bitPosition;  // posisi bit node berikutnya, dihitung dari awal body
+};
+
+enum QTCStreamStatus {
+    QTC_STREAM_NEED_MORE,
+    QTC_STREAM_COMPLETE,
+    QTC_STREAM_ERROR
+};
+
+// Fungsi untuk encode dan decode quadtree ke/dari buffer .qtc
+bool encodeQTC(const QuadTree& tree, int minBlockSize, std::vector<BYTE>& output);
+bool readQTCHeader(const BYTE* data, size_t size, QTCHeader& header);
+bool decodeQTC(const BYTE* data, size_t size, QuadTree& tree);
+
+// Fungsi untuk encode progresif: startQTCStream menulis header dan tabel kode ke output,
+// writeQTCStream menambahkan node berikutnya hingga output bertambah minimal maxBytes
+// (mengembalikan true jika stream sudah selesai dan ditutup)
+bool startQTCStream(const QuadTree& tree, int minBlockSize, QTCStreamEncoder& encoder, std::vector<BYTE>& output);
+bool writeQTCStream(QTCStreamEncoder& encoder, std::vector<BYTE>& output, size_t maxBytes);
+bool encodeQTCProgressive(const QuadTree& tree, int minBlockSize, std::vector<BYTE>& output);
+
+// Fungsi untuk decode progresif: data adalah seluruh byte yang sudah diterima sejak awal
+// stream. Pemanggilan berikutnya dengan data yang lebih panjang melanjutkan dari node terakhir.
+void resetQTCStreamDecoder(QTCStreamDecoder& decoder);
+QTCStreamStatus readQTCStream(QTCStreamDecoder& decoder, const BYTE* data, size_t size);
+
+// Fungsi untuk me-render buffer .qtc (misalnya hasil mapFile) langsung ke buffer pixel milik
+// pemanggil tanpa membangun QuadTreeNode. Buffer berukuran lebar x tinggi dari header, 3 byte
+// per pixel (R, G, B atau B, G, R jika bgrOrder), baris ke-j berada di pixels + j * pitch dan
+// sama dengan baris ke-j pada ImageView. Isi buffer tidak lengkap jika fungsi gagal.
+bool renderQTC(const BYTE* data, size_t size, BYTE* pixels, int pitch, bool bgrOrder = false);
+
+// Fungsi untuk menyimpan dan memuat file .qtc
+bool saveQTC(const QuadTree& tree, int minBlockSize, const std::string& path);
+bool saveQTC(const std::vector<BYTE>& buffer, const std::string& path);
+bool loadQTC(const std::string& path, QuadTree& tree);
+
+#endif
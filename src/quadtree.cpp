@@ -1,72 +1,399 @@
 #include "quadtree.h"
+#include "simd_kernels.h"
 #include <cmath>
 #include <functional>
 #include <algorithm>
+#include <cstring>
 
-// CTOR dan DTOR
-QuadTreeNode::QuadTreeNode(int _x, int _y, int _width, int _height)
-    : x(_x), y(_y), width(_width), height(_height), isLeaf(false),
-      topLeft(nullptr), topRight(nullptr), bottomLeft(nullptr), bottomRight(nullptr) {
-    avgColor.rgbRed = 0;
-    avgColor.rgbGreen = 0;
-    avgColor.rgbBlue = 0;
-    avgColor.rgbReserved = 0;
+// Fungsi untuk menambahkan node daun baru di akhir array, mengembalikan indeksnya
+int addQuadTreeNode(QuadTree& tree, int x, int y, int width, int height) {
+    QuadTreeNode node;
+    node.x = x;
+    node.y = y;
+    node.width = width;
+    node.height = height;
+    node.avgColor = {0, 0, 0, 0};
+    node.firstChild = -1;
+    
+    tree.nodes.push_back(node);
+    return static_cast<int>(tree.nodes.size()) - 1;
 }
 
-QuadTreeNode::~QuadTreeNode() {
-    if (topLeft) delete topLeft;
-    if (topRight) delete topRight;
-    if (bottomLeft) delete bottomLeft;
-    if (bottomRight) delete bottomRight;
+// Fungsi untuk membagi node menjadi 4 anak yang bersebelahan, mengembalikan indeks anak pertama
+int splitQuadTreeNode(QuadTree& tree, int index) {
+    // Salin geometri dulu karena push_back dapat memindahkan isi array
+    int x = tree.nodes[index].x;
+    int y = tree.nodes[index].y;
+    int width = tree.nodes[index].width;
+    int height = tree.nodes[index].height;
+    
+    int halfWidth = width / 2;
+    int halfHeight = height / 2;
+    
+    int first = addQuadTreeNode(tree, x, y, halfWidth, halfHeight);
+    addQuadTreeNode(tree, x + halfWidth, y, width - halfWidth, halfHeight);
+    addQuadTreeNode(tree, x, y + halfHeight, halfWidth, height - halfHeight);
+    addQuadTreeNode(tree, x + halfWidth, y + halfHeight, width - halfWidth, height - halfHeight);
+    
+    tree.nodes[index].firstChild = first;
+    return first;
+}
+
+// Fungsi untuk mengecek apakah blok berukuran width x height masih boleh dibagi:
+// blok tidak dibagi jika sudah minimum atau hasil pembagiannya lebih kecil dari minimum
+bool canSplitQuadTreeBlock(int width, int height, int minBlockSize) {
+    return !(width <= minBlockSize || height <= minBlockSize || 
+             width/2 < minBlockSize || height/2 < minBlockSize);
+}
+
+// Fungsi untuk membuat kanvas planar kosong (hitam)
+ImageView createImageView(int width, int height, int channels) {
+    ImageView view;
+    view.width = width;
+    view.height = height;
+    view.channels = channels;
+    
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    for (int c = 0; c < channels; c++) {
+        view.planes[c].assign(pixelCount, 0);
+    }
+    
+    return view;
+}
+
+// Format bitmap yang dibaca langsung tanpa FreeImage_ConvertTo24Bits
+enum BitmapLayout {
+    LAYOUT_GRAY8,       // 8 bit dengan palet grayscale linear, menjadi ImageView satu channel
+    LAYOUT_PALETTE8,    // 8 bit dengan palet warna
+    LAYOUT_BGR24,
+    LAYOUT_BGRA32
+};
+
+// Fungsi untuk menyalin satu scanline ke baris planar, dispesialisasi per format agar
+// loop dalamnya tidak bercabang
+template <BitmapLayout Layout>
+static void copyScanline(const BYTE* scanline, const RGBQUAD* palette, int width,
+                         BYTE* rowR, BYTE* rowG, BYTE* rowB);
+
+template <>
+void copyScanline<LAYOUT_GRAY8>(const BYTE* scanline, const RGBQUAD*, int width, BYTE* rowR, BYTE*, BYTE*) {
+    memcpy(rowR, scanline, width);
+}
+
+template <>
+void copyScanline<LAYOUT_PALETTE8>(const BYTE* scanline, const RGBQUAD* palette, int width,
+                                   BYTE* rowR, BYTE* rowG, BYTE* rowB) {
+    for (int i = 0; i < width; i++) {
+        const RGBQUAD& color = palette[scanline[i]];
+        rowR[i] = color.rgbRed;
+        rowG[i] = color.rgbGreen;
+        rowB[i] = color.rgbBlue;
+    }
+}
+
+template <int BytesPerPixel>
+static void copyColorScanline(const BYTE* scanline, int width, BYTE* rowR, BYTE* rowG, BYTE* rowB) {
+    for (int i = 0; i < width; i++) {
+        rowR[i] = scanline[FI_RGBA_RED];
+        rowG[i] = scanline[FI_RGBA_GREEN];
+        rowB[i] = scanline[FI_RGBA_BLUE];
+        scanline += BytesPerPixel;
+    }
+}
+
+template <>
+void copyScanline<LAYOUT_BGR24>(const BYTE* scanline, const RGBQUAD*, int width,
+                                BYTE* rowR, BYTE* rowG, BYTE* rowB) {
+    copyColorScanline<3>(scanline, width, rowR, rowG, rowB);
+}
+
+template <>
+void copyScanline<LAYOUT_BGRA32>(const BYTE* scanline, const RGBQUAD*, int width,
+                                 BYTE* rowR, BYTE* rowG, BYTE* rowB) {
+    copyColorScanline<4>(scanline, width, rowR, rowG, rowB);
+}
+
+// Fungsi untuk menyalin seluruh bitmap ke bentuk planar, dibaca langsung per scanline
+template <BitmapLayout Layout>
+static ImageView copyBitmap(FIBITMAP* image) {
+    int width = FreeImage_GetWidth(image);
+    int height = FreeImage_GetHeight(image);
+    ImageView view = createImageView(width, height, Layout == LAYOUT_GRAY8 ? 1 : 3);
+    const RGBQUAD* palette = FreeImage_GetPalette(image);
+    
+    for (int j = 0; j < height; j++) {
+        copyScanline<Layout>(FreeImage_GetScanLine(image, j), palette, width,
+                             view.row(0, j), view.row(1, j), view.row(2, j));
+    }
+    
+    return view;
+}
+
+// Fungsi untuk menyalin pixel bitmap ke bentuk planar. Hanya format yang tidak dikenali
+// (misalnya 1/4/16 bit, 48 bit atau float) yang dikonversi ke salinan 24 bit sementara
+ImageView createImageView(FIBITMAP* image) {
+    if (FreeImage_GetImageType(image) == FIT_BITMAP) {
+        switch (FreeImage_GetBPP(image)) {
+            case 8:
+                if (FreeImage_GetColorType(image) == FIC_MINISBLACK) {
+                    return copyBitmap<LAYOUT_GRAY8>(image);
+                }
+                if (FreeImage_GetPalette(image)) {
+                    return copyBitmap<LAYOUT_PALETTE8>(image);
+                }
+                break;
+            case 24:
+                return copyBitmap<LAYOUT_BGR24>(image);
+            case 32:
+                return copyBitmap<LAYOUT_BGRA32>(image);
+        }
+    }
+    
+    FIBITMAP* converted = FreeImage_ConvertTo24Bits(image);
+    if (!converted) {
+        return createImageView(0, 0);
+    }
+    
+    ImageView view = copyBitmap<LAYOUT_BGR24>(converted);
+    FreeImage_Unload(converted);
+    return view;
+}
+
+// Fungsi untuk menulis kembali kanvas planar ke bitmap 24 bit (dipakai saat menyimpan)
+FIBITMAP* createBitmapFromView(const ImageView& view) {
+    FIBITMAP* bitmap = FreeImage_Allocate(view.width, view.height, 24);
+    if (!bitmap) return nullptr;
+    
+    for (int j = 0; j < view.height; j++) {
+        const BYTE* rowR = view.row(0, j);
+        const BYTE* rowG = view.row(1, j);
+        const BYTE* rowB = view.row(2, j);
+        BYTE* scanline = FreeImage_GetScanLine(bitmap, j);
+        
+        for (int i = 0; i < view.width; i++) {
+            scanline[FI_RGBA_RED] = rowR[i];
+            scanline[FI_RGBA_GREEN] = rowG[i];
+            scanline[FI_RGBA_BLUE] = rowB[i];
+            scanline += 3;
+        }
+    }
+    
+    return bitmap;
+}
+
+// Fungsi untuk mewarnai sebuah blok pada kanvas planar
+void fillRectangle(ImageView& view, int x, int y, int width, int height, RGBQUAD color) {
+    for (int j = y; j < y + height; j++) {
+        std::fill(view.row(0, j) + x, view.row(0, j) + x + width, color.rgbRed);
+        std::fill(view.row(1, j) + x, view.row(1, j) + x + width, color.rgbGreen);
+        std::fill(view.row(2, j) + x, view.row(2, j) + x + width, color.rgbBlue);
+    }
 }
 
 // Fungsi untuk menghitung rata-rata warna dalam suatu blok
-RGBQUAD calculateAverageColor(FIBITMAP* image, int x, int y, int width, int height) {
+RGBQUAD calculateAverageColor(const ImageView& image, int x, int y, int width, int height) {
     RGBQUAD avgColor = {0, 0, 0, 0};
-    unsigned long long totalRed = 0, totalGreen = 0, totalBlue = 0;
-    int pixelCount = 0;
+    unsigned long long total[3] = {0, 0, 0};
+    long long pixelCount = width > 0 && height > 0 ? static_cast<long long>(width) * height : 0;
+    
+    for (int c = 0; c < image.channels; c++) {
+        for (int j = y; j < y + height; j++) {
+            const BYTE* row = image.row(c, j);
+            for (int i = x; i < x + width; i++) {
+                total[c] += row[i];
+            }
+        }
+    }
     
-    for (int j = y; j < y + height; j++) {
-        for (int i = x; i < x + width; i++) {
-            RGBQUAD pixel;
-            FreeImage_GetPixelColor(image, i, j, &pixel);
+    if (image.isGrayscale()) {
+        total[1] = total[2] = total[0];
+    }
+    
+    if (pixelCount > 0) {
+        avgColor.rgbRed = static_cast<BYTE>(total[0] / pixelCount);
+        avgColor.rgbGreen = static_cast<BYTE>(total[1] / pixelCount);
+        avgColor.rgbBlue = static_cast<BYTE>(total[2] / pixelCount);
+    }
+    
+    return avgColor;
+}
+
+// Fungsi untuk merata-ratakan error ketiga channel (channel grayscale disalin dari R)
+double averageChannelError(double channelError[3], int channels) {
+    if (channels == 1) {
+        channelError[1] = channelError[2] = channelError[0];
+    }
+    return (channelError[0] + channelError[1] + channelError[2]) / 3.0;
+}
+
+// Fungsi untuk mengisi tabel channel R saja untuk gambar grayscale (satu kali scan)
+static void buildGrayscaleIntegral(const ImageView& image, IntegralImage& integral, size_t stride) {
+    for (int j = 0; j < integral.height; j++) {
+        const BYTE* row = image.row(0, j);
+        unsigned long long run = 0, runSq = 0;
+        
+        size_t above = static_cast<size_t>(j) * stride;
+        size_t current = above + stride;
+        
+        for (int i = 0; i < integral.width; i++) {
+            run += row[i];
+            runSq += static_cast<unsigned long long>(row[i]) * row[i];
+            
+            integral.sumR[current + i + 1] = integral.sumR[above + i + 1] + run;
+            integral.sqR[current + i + 1] = integral.sqR[above + i + 1] + runSq;
+        }
+    }
+}
+
+// Fungsi untuk membangun integral image dari gambar (satu kali scan). Gambar grayscale hanya
+// membutuhkan tabel channel R, sepertiga memori dan waktu versi RGB
+IntegralImage buildIntegralImage(const ImageView& image) {
+    IntegralImage integral;
+    integral.width = image.width;
+    integral.height = image.height;
+    integral.channels = image.channels;
+    
+    size_t stride = static_cast<size_t>(integral.width) + 1;
+    size_t total = stride * (static_cast<size_t>(integral.height) + 1);
+    
+    integral.sumR.assign(total, 0);
+    integral.sqR.assign(total, 0);
+    
+    if (image.isGrayscale()) {
+        buildGrayscaleIntegral(image, integral, stride);
+        return integral;
+    }
+    
+    integral.sumG.assign(total, 0);
+    integral.sumB.assign(total, 0);
+    integral.sqG.assign(total, 0);
+    integral.sqB.assign(total, 0);
+    
+    for (int j = 0; j < integral.height; j++) {
+        const BYTE* rowR = image.row(0, j);
+        const BYTE* rowG = image.row(1, j);
+        const BYTE* rowB = image.row(2, j);
+        
+        unsigned long long runR = 0, runG = 0, runB = 0;
+        unsigned long long runSqR = 0, runSqG = 0, runSqB = 0;
+        
+        size_t above = static_cast<size_t>(j) * stride;
+        size_t current = above + stride;
+        
+        for (int i = 0; i < integral.width; i++) {
+            runR += rowR[i];
+            runG += rowG[i];
+            runB += rowB[i];
+            runSqR += static_cast<unsigned long long>(rowR[i]) * rowR[i];
+            runSqG += static_cast<unsigned long long>(rowG[i]) * rowG[i];
+            runSqB += static_cast<unsigned long long>(rowB[i]) * rowB[i];
             
-            totalRed += pixel.rgbRed;
-            totalGreen += pixel.rgbGreen;
-            totalBlue += pixel.rgbBlue;
-            pixelCount++;
+            // Nilai (i + 1, j + 1) = jumlah baris berjalan + nilai satu baris di atasnya
+            integral.sumR[current + i + 1] = integral.sumR[above + i + 1] + runR;
+            integral.sumG[current + i + 1] = integral.sumG[above + i + 1] + runG;
+            integral.sumB[current + i + 1] = integral.sumB[above + i + 1] + runB;
+            integral.sqR[current + i + 1] = integral.sqR[above + i + 1] + runSqR;
+            integral.sqG[current + i + 1] = integral.sqG[above + i + 1] + runSqG;
+            integral.sqB[current + i + 1] = integral.sqB[above + i + 1] + runSqB;
         }
     }
     
+    return integral;
+}
+
+// Jumlah nilai tabel pada persegi panjang (x, y, width, height) dalam O(1)
+static unsigned long long rectangleSum(const std::vector<unsigned long long>& table, size_t stride,
+                                       int x, int y, int width, int height) {
+    size_t top = static_cast<size_t>(y) * stride;
+    size_t bottom = static_cast<size_t>(y + height) * stride;
+    
+    return table[bottom + x + width] - table[bottom + x] - table[top + x + width] + table[top + x];
+}
+
+// Tabel jumlah dan jumlah kuadrat per channel; gambar grayscale memakai tabel R untuk ketiganya
+static void integralTables(const IntegralImage& integral, const std::vector<unsigned long long>* sums[3],
+                           const std::vector<unsigned long long>* squares[3]) {
+    bool grayscale = integral.channels == 1;
+    sums[0] = &integral.sumR;
+    sums[1] = grayscale ? &integral.sumR : &integral.sumG;
+    sums[2] = grayscale ? &integral.sumR : &integral.sumB;
+    squares[0] = &integral.sqR;
+    squares[1] = grayscale ? &integral.sqR : &integral.sqG;
+    squares[2] = grayscale ? &integral.sqR : &integral.sqB;
+}
+
+// Fungsi untuk menghitung rata-rata warna blok menggunakan integral image
+RGBQUAD calculateAverageColor(const IntegralImage& integral, int x, int y, int width, int height) {
+    RGBQUAD avgColor = {0, 0, 0, 0};
+    unsigned long long pixelCount = static_cast<unsigned long long>(width) * height;
+    
     if (pixelCount > 0) {
-        avgColor.rgbRed = static_cast<BYTE>(totalRed / pixelCount);
-        avgColor.rgbGreen = static_cast<BYTE>(totalGreen / pixelCount);
-        avgColor.rgbBlue = static_cast<BYTE>(totalBlue / pixelCount);
+        size_t stride = static_cast<size_t>(integral.width) + 1;
+        
+        // Pembagian integer agar hasilnya sama persis dengan versi per-pixel
+        avgColor.rgbRed = static_cast<BYTE>(rectangleSum(integral.sumR, stride, x, y, width, height) / pixelCount);
+        if (integral.channels == 1) {
+            avgColor.rgbGreen = avgColor.rgbBlue = avgColor.rgbRed;
+        } else {
+            avgColor.rgbGreen = static_cast<BYTE>(rectangleSum(integral.sumG, stride, x, y, width, height) / pixelCount);
+            avgColor.rgbBlue = static_cast<BYTE>(rectangleSum(integral.sumB, stride, x, y, width, height) / pixelCount);
+        }
     }
     
     return avgColor;
 }
 
 // Fungsi untuk menghitung variance
-double calculateVariance(FIBITMAP* image, int x, int y, int width, int height, RGBQUAD avgColor) {
-    double varR = 0, varG = 0, varB = 0;
+double calculateVariance(const ImageView& image, int x, int y, int width, int height, RGBQUAD avgColor) {
+    const RowKernels& kernels = getRowKernels();
+    const BYTE avg[3] = {avgColor.rgbRed, avgColor.rgbGreen, avgColor.rgbBlue};
+    double variance[3] = {0, 0, 0};
     int N = width * height;
     
-    for (int j = y; j < y + height; j++) {
-        for (int i = x; i < x + width; i++) {
-            RGBQUAD pixel;
-            FreeImage_GetPixelColor(image, i, j, &pixel);
-            
-            double diffR = pixel.rgbRed - avgColor.rgbRed;
-            double diffG = pixel.rgbGreen - avgColor.rgbGreen;
-            double diffB = pixel.rgbBlue - avgColor.rgbBlue;
-            
-            varR += diffR * diffR;
-            varG += diffG * diffG;
-            varB += diffB * diffB;
+    // Jumlah kuadrat selisih dihitung eksak per baris dengan kernel SIMD
+    for (int c = 0; c < image.channels; c++) {
+        unsigned long long sum = 0;
+        for (int j = y; j < y + height; j++) {
+            sum += kernels.squaredDeviation(image.row(c, j) + x, width, avg[c]);
+        }
+        
+        variance[c] = static_cast<double>(sum);
+        if (N > 0) {
+            variance[c] /= N;
         }
     }
     
+    return averageChannelError(variance, image.channels);
+}
+
+// Sum((p - avg)^2) = sumSq - 2 * avg * sum + N * avg^2, dihitung eksak dengan integer
+static double channelSquaredDeviation(unsigned long long sum, unsigned long long sumSq,
+                                      unsigned long long N, BYTE avg) {
+    long long deviation = static_cast<long long>(sumSq) - 2LL * avg * static_cast<long long>(sum) +
+                          static_cast<long long>(N) * avg * avg;
+    return static_cast<double>(deviation);
+}
+
+// Fungsi untuk menghitung variance menggunakan integral image
+double calculateVariance(const IntegralImage& integral, int x, int y, int width, int height, RGBQUAD avgColor) {
+    unsigned long long N = static_cast<unsigned long long>(width) * height;
+    size_t stride = static_cast<size_t>(integral.width) + 1;
+    
+    double varR = channelSquaredDeviation(rectangleSum(integral.sumR, stride, x, y, width, height),
+                                          rectangleSum(integral.sqR, stride, x, y, width, height),
+                                          N, avgColor.rgbRed);
+    if (integral.channels == 1) {
+        double variance[3] = {N > 0 ? varR / N : varR, 0, 0};
+        return averageChannelError(variance, 1);
+    }
+    
+    double varG = channelSquaredDeviation(rectangleSum(integral.sumG, stride, x, y, width, height),
+                                          rectangleSum(integral.sqG, stride, x, y, width, height),
+                                          N, avgColor.rgbGreen);
+    double varB = channelSquaredDeviation(rectangleSum(integral.sumB, stride, x, y, width, height),
+                                          rectangleSum(integral.sqB, stride, x, y, width, height),
+                                          N, avgColor.rgbBlue);
+    
     if (N > 0) {
         varR /= N;
         varG /= N;
@@ -77,216 +404,381 @@ double calculateVariance(FIBITMAP* image, int x, int y, int width, int height, R
 }
 
 // Fungsi untuk menghitung Mean Absolute Deviation (MAD)
-double calculateMAD(FIBITMAP* image, int x, int y, int width, int height, RGBQUAD avgColor) {
-    double madR = 0, madG = 0, madB = 0;
+double calculateMAD(const ImageView& image, int x, int y, int width, int height, RGBQUAD avgColor) {
+    const RowKernels& kernels = getRowKernels();
+    const BYTE avg[3] = {avgColor.rgbRed, avgColor.rgbGreen, avgColor.rgbBlue};
+    double mad[3] = {0, 0, 0};
     int N = width * height;
     
-    for (int j = y; j < y + height; j++) {
-        for (int i = x; i < x + width; i++) {
-            RGBQUAD pixel;
-            FreeImage_GetPixelColor(image, i, j, &pixel);
-            
-            madR += abs(static_cast<int>(pixel.rgbRed) - avgColor.rgbRed);
-            madG += abs(static_cast<int>(pixel.rgbGreen) - avgColor.rgbGreen);
-            madB += abs(static_cast<int>(pixel.rgbBlue) - avgColor.rgbBlue);
+    for (int c = 0; c < image.channels; c++) {
+        unsigned long long sum = 0;
+        for (int j = y; j < y + height; j++) {
+            sum += kernels.absoluteDeviation(image.row(c, j) + x, width, avg[c]);
+        }
+        
+        mad[c] = static_cast<double>(sum);
+        if (N > 0) {
+            mad[c] /= N;
         }
     }
     
-    if (N > 0) {
-        madR /= N;
-        madG /= N;
-        madB /= N;
-    }
-    
-    return (madR + madG + madB) / 3.0;
+    return averageChannelError(mad, image.channels);
 }
 
 // Fungsi untuk menghitung Max Pixel Difference
-double calculateMaxDifference(FIBITMAP* image, int x, int y, int width, int height) {
-    BYTE minR = 255, minG = 255, minB = 255;
-    BYTE maxR = 0, maxG = 0, maxB = 0;
-    
-    for (int j = y; j < y + height; j++) {
-        for (int i = x; i < x + width; i++) {
-            RGBQUAD pixel;
-            FreeImage_GetPixelColor(image, i, j, &pixel);
-            
-            minR = std::min(minR, pixel.rgbRed);
-            minG = std::min(minG, pixel.rgbGreen);
-            minB = std::min(minB, pixel.rgbBlue);
-            
-            maxR = std::max(maxR, pixel.rgbRed);
-            maxG = std::max(maxG, pixel.rgbGreen);
-            maxB = std::max(maxB, pixel.rgbBlue);
+double calculateMaxDifference(const ImageView& image, int x, int y, int width, int height) {
+    const RowKernels& kernels = getRowKernels();
+    double difference[3] = {0, 0, 0};
+    
+    for (int c = 0; c < image.channels; c++) {
+        BYTE minValue = 255, maxValue = 0;
+        for (int j = y; j < y + height; j++) {
+            kernels.minMax(image.row(c, j) + x, width, minValue, maxValue);
         }
+        difference[c] = maxValue - minValue;
     }
     
-    double diffR = maxR - minR;
-    double diffG = maxG - minG;
-    double diffB = maxB - minB;
+    return averageChannelError(difference, image.channels);
+}
+
+// Tabel n * log2(n) untuk frekuensi kecil, dibuat sekali saat pertama dipakai
+static const int NLOG2N_TABLE_SIZE = 1 << 16;
+
+static double nLog2n(unsigned long long n) {
+    static const std::vector<double> table = [] {
+        std::vector<double> values(NLOG2N_TABLE_SIZE, 0.0);
+        for (int i = 1; i < NLOG2N_TABLE_SIZE; i++) {
+            values[i] = i * log2(static_cast<double>(i));
+        }
+        return values;
+    }();
     
-    return (diffR + diffG + diffB) / 3.0;
+    if (n < static_cast<unsigned long long>(NLOG2N_TABLE_SIZE)) {
+        return table[n];
+    }
+    return static_cast<double>(n) * log2(static_cast<double>(n));
 }
 
-// Fungsi untuk menghitung Entropy
-double calculateEntropy(FIBITMAP* image, int x, int y, int width, int height) {
-    int histR[256] = {0}, histG[256] = {0}, histB[256] = {0};
-    int N = width * height;
+// Fungsi untuk menghitung entropy satu channel dari histogramnya.
+// -Sum(p * log2(p)) dengan p = h / N sama dengan (N * log2(N) - Sum(h * log2(h))) / N,
+// sehingga tidak ada log2 per bin dan blok seragam menghasilkan tepat 0
+double calculateHistogramEntropy(const int histogram[256], unsigned long long pixelCount) {
+    if (pixelCount == 0) {
+        return 0;
+    }
     
-    for (int j = y; j < y + height; j++) {
-        for (int i = x; i < x + width; i++) {
-            RGBQUAD pixel;
-            FreeImage_GetPixelColor(image, i, j, &pixel);
-            
-            histR[pixel.rgbRed]++;
-            histG[pixel.rgbGreen]++;
-            histB[pixel.rgbBlue]++;
+    double sum = 0;
+    for (int v = 0; v < 256; v++) {
+        if (histogram[v] > 0) {
+            sum += nLog2n(histogram[v]);
         }
     }
     
-    // Hitung entropy
-    double entropyR = 0, entropyG = 0, entropyB = 0;
-    
-    for (int i = 0; i < 256; i++) {
-        if (histR[i] > 0) {
-            double pR = static_cast<double>(histR[i]) / N;
-            entropyR -= pR * log2(pR);
+    double entropy = (nLog2n(pixelCount) - sum) / pixelCount;
+    return entropy > 0 ? entropy : 0;
+}
+
+// Blok di bawah batas ini tidak memakai histogram 256 bin: nilai pixel diurutkan lalu
+// frekuensinya dihitung per run. Urutan penjumlahan sama dengan iterasi bin histogram,
+// sehingga hasilnya identik dengan calculateHistogramEntropy
+static const int SMALL_ENTROPY_PIXELS = 256;
+
+static double sortedChannelEntropy(BYTE* values, int count) {
+    std::sort(values, values + count);
+    
+    double sum = 0;
+    for (int start = 0; start < count; ) {
+        int end = start + 1;
+        while (end < count && values[end] == values[start]) {
+            end++;
         }
+        sum += nLog2n(end - start);
+        start = end;
+    }
+    
+    double entropy = (nLog2n(count) - sum) / static_cast<unsigned long long>(count);
+    return entropy > 0 ? entropy : 0;
+}
+
+// Fungsi untuk menghitung Entropy
+double calculateEntropy(const ImageView& image, int x, int y, int width, int height) {
+    unsigned long long N = static_cast<unsigned long long>(width) * height;
+    double entropy[3] = {0, 0, 0};
+    
+    if (N > 0 && N < static_cast<unsigned long long>(SMALL_ENTROPY_PIXELS)) {
+        BYTE values[SMALL_ENTROPY_PIXELS];
         
-        if (histG[i] > 0) {
-            double pG = static_cast<double>(histG[i]) / N;
-            entropyG -= pG * log2(pG);
+        for (int c = 0; c < image.channels; c++) {
+            int count = 0;
+            for (int j = y; j < y + height; j++) {
+                const BYTE* row = image.row(c, j);
+                for (int i = x; i < x + width; i++) {
+                    values[count++] = row[i];
+                }
+            }
+            entropy[c] = sortedChannelEntropy(values, count);
         }
         
-        if (histB[i] > 0) {
-            double pB = static_cast<double>(histB[i]) / N;
-            entropyB -= pB * log2(pB);
+        return averageChannelError(entropy, image.channels);
+    }
+    
+    for (int c = 0; c < image.channels; c++) {
+        int histogram[256] = {0};
+        for (int j = y; j < y + height; j++) {
+            const BYTE* row = image.row(c, j);
+            for (int i = x; i < x + width; i++) {
+                histogram[row[i]]++;
+            }
         }
+        entropy[c] = calculateHistogramEntropy(histogram, N);
     }
     
-    return (entropyR + entropyG + entropyB) / 3.0;
+    return averageChannelError(entropy, image.channels);
+}
+
+// Sum((p - mean)^2) dengan mean = sum / N (bukan dibulatkan), dihitung tanpa overflow:
+// sum = N * q + r, sehingga Sum((p - mean)^2) = sumSq - N * q^2 - 2 * q * r - r^2 / N
+static double channelCentralMoment(unsigned long long sum, unsigned long long sumSq, unsigned long long N) {
+    unsigned long long q = sum / N;
+    unsigned long long r = sum % N;
+    unsigned long long integerPart = sumSq - N * q * q - 2 * q * r;
+    
+    return static_cast<double>(integerPart) - static_cast<double>(r * r) / N;
 }
 
-// Fungsi untuk menghitung SSIM 
-double calculateSSIM(FIBITMAP* image, int x, int y, int width, int height, RGBQUAD avgColor) {
-    // Konstanta untuk stabilitas
+// SSIM antara blok asli (mean dan variansi per channel) dan blok warna rata-rata. Untuk gambar
+// grayscale hanya channel 0 yang diisi dan SSIM channel itu dipakai untuk ketiga bobot
+static double ssimErrorFromMoments(const double muX[3], const double sigmaX2[3], RGBQUAD avgColor, int channels) {
     const double C1 = 6.5025;   // (0.01 * 255)²
     const double C2 = 58.5225;  // (0.03 * 255)²
+    const double weights[3] = {0.33333, 0.33333, 0.33334};
+    
+    // Target berwarna konstan sehingga variansi target dan kovariansinya nol
+    const double muY[3] = {
+        static_cast<double>(avgColor.rgbRed),
+        static_cast<double>(avgColor.rgbGreen),
+        static_cast<double>(avgColor.rgbBlue)
+    };
+    const double sigmaY2 = 0;
+    const double sigmaXY = 0;
+    
+    double ssim = 0;
+    double channelSsim = 0;
+    for (int c = 0; c < 3; c++) {
+        if (c < channels) {
+            channelSsim = ((2 * muX[c] * muY[c] + C1) * (2 * sigmaXY + C2)) / 
+                          ((muX[c] * muX[c] + muY[c] * muY[c] + C1) * (sigmaX2[c] + sigmaY2 + C2));
+        }
+        ssim += weights[c] * channelSsim;
+    }
     
-    // Bobot untuk setiap channel (defaultnya sama)
-    const double wR = 0.33333, wG = 0.33333, wB = 0.33334;
-    
-    std::vector<double> sourceR, sourceG, sourceB;
-    std::vector<double> targetR, targetG, targetB;
+    const double SCALE_FACTOR = 10000.0;
+    return (1.0 - ssim) * SCALE_FACTOR;
+}
+
+// Fungsi untuk menghitung SSIM dalam satu kali scan tanpa buffer sementara.
+// Target adalah blok berwarna avgColor (dari pemanggil) sehingga hanya
+// jumlah dan jumlah kuadrat pixel sumber yang dibutuhkan
+double calculateSSIM(const ImageView& image, int x, int y, int width, int height, RGBQUAD avgColor) {
+    unsigned long long sum[3] = {0, 0, 0};
+    unsigned long long sumSq[3] = {0, 0, 0};
+    unsigned long long N = static_cast<unsigned long long>(width) * height;
     
-    // Isi gambar sumber dari blok asli
     for (int j = y; j < y + height; j++) {
-        for (int i = x; i < x + width; i++) {
-            RGBQUAD pixel;
-            FreeImage_GetPixelColor(image, i, j, &pixel);
+        for (int c = 0; c < image.channels; c++) {
+            const BYTE* row = image.row(c, j);
+            unsigned int rowSum = 0;
+            unsigned long long rowSumSq = 0;
             
-            sourceR.push_back(static_cast<double>(pixel.rgbRed));
-            sourceG.push_back(static_cast<double>(pixel.rgbGreen));
-            sourceB.push_back(static_cast<double>(pixel.rgbBlue));
+            for (int i = x; i < x + width; i++) {
+                rowSum += row[i];
+                rowSumSq += static_cast<unsigned int>(row[i]) * row[i];
+            }
             
-            // Gambar target adalah blok dengan warna rata-rata yang sama
-            targetR.push_back(static_cast<double>(avgColor.rgbRed));
-            targetG.push_back(static_cast<double>(avgColor.rgbGreen));
-            targetB.push_back(static_cast<double>(avgColor.rgbBlue));
+            sum[c] += rowSum;
+            sumSq[c] += rowSumSq;
         }
     }
     
-    // Hitung statistik untuk setiap channel warna
-    // Sumber (gambar asli)
-    double muX_R = 0, muX_G = 0, muX_B = 0;
-    double sigmaX2_R = 0, sigmaX2_G = 0, sigmaX2_B = 0;
+    if (N == 0) {
+        return 0;
+    }
     
-    // Target (gambar dengan warna konstan rata-rata)
-    double muY_R = avgColor.rgbRed;
-    double muY_G = avgColor.rgbGreen;
-    double muY_B = avgColor.rgbBlue;
-    double sigmaY2_R = 0, sigmaY2_G = 0, sigmaY2_B = 0;  
+    double muX[3] = {0, 0, 0}, sigmaX2[3] = {0, 0, 0};
+    for (int c = 0; c < image.channels; c++) {
+        muX[c] = static_cast<double>(sum[c]) / N;
+        sigmaX2[c] = channelCentralMoment(sum[c], sumSq[c], N) / N;
+    }
     
-    // Kovariansi
-    double sigmaXY_R = 0, sigmaXY_G = 0, sigmaXY_B = 0;
+    return ssimErrorFromMoments(muX, sigmaX2, avgColor, image.channels);
+}
+
+// Fungsi untuk menghitung SSIM menggunakan integral image (mean dan variansi dalam O(1))
+double calculateSSIM(const IntegralImage& integral, int x, int y, int width, int height, RGBQUAD avgColor) {
+    unsigned long long N = static_cast<unsigned long long>(width) * height;
+    size_t stride = static_cast<size_t>(integral.width) + 1;
     
-    // Hitung mean
-    int n = sourceR.size();
-    for (int i = 0; i < n; i++) {
-        muX_R += sourceR[i];
-        muX_G += sourceG[i];
-        muX_B += sourceB[i];
+    if (N == 0) {
+        return 0;
     }
     
-    muX_R /= n;
-    muX_G /= n;
-    muX_B /= n;
+    const std::vector<unsigned long long>* sums[3];
+    const std::vector<unsigned long long>* squares[3];
+    integralTables(integral, sums, squares);
     
-    // Hitung variansi dan kovariansi
-    for (int i = 0; i < n; i++) {
-        double diffX_R = sourceR[i] - muX_R;
-        double diffX_G = sourceG[i] - muX_G;
-        double diffX_B = sourceB[i] - muX_B;
+    double muX[3] = {0, 0, 0}, sigmaX2[3] = {0, 0, 0};
+    for (int c = 0; c < integral.channels; c++) {
+        unsigned long long sum = rectangleSum(*sums[c], stride, x, y, width, height);
+        unsigned long long sumSq = rectangleSum(*squares[c], stride, x, y, width, height);
         
-        sigmaX2_R += diffX_R * diffX_R;
-        sigmaX2_G += diffX_G * diffX_G;
-        sigmaX2_B += diffX_B * diffX_B;
-        
-        sigmaXY_R += diffX_R * (targetR[i] - muY_R);
-        sigmaXY_G += diffX_G * (targetG[i] - muY_G);
-        sigmaXY_B += diffX_B * (targetB[i] - muY_B);
+        muX[c] = static_cast<double>(sum) / N;
+        sigmaX2[c] = channelCentralMoment(sum, sumSq, N) / N;
     }
     
-    sigmaX2_R /= n;
-    sigmaX2_G /= n;
-    sigmaX2_B /= n;
-    
-    sigmaXY_R /= n;
-    sigmaXY_G /= n;
-    sigmaXY_B /= n;
+    return ssimErrorFromMoments(muX, sigmaX2, avgColor, integral.channels);
+}
+
+// Fungsi untuk mengumpulkan rata-rata, jumlah kuadrat, min/max dan histogram dalam satu scan
+BlockStats calculateBlockStats(const ImageView& image, int x, int y, int width, int height, bool withHistogram) {
+    BlockStats stats;
+    stats.pixelCount = 0;
+    stats.channels = image.channels;
+    stats.avgColor = {0, 0, 0, 0};
+    stats.hasHistogram = withHistogram;
+    
+    for (int c = 0; c < 3; c++) {
+        stats.sum[c] = 0;
+        stats.sumSq[c] = 0;
+        stats.minValue[c] = 255;
+        stats.maxValue[c] = 0;
+    }
     
-    // Hitung SSIM untuk setiap channel
-    double ssim_R = ((2 * muX_R * muY_R + C1) * (2 * sigmaXY_R + C2)) / 
-                   ((muX_R * muX_R + muY_R * muY_R + C1) * (sigmaX2_R + sigmaY2_R + C2));
-                   
-    double ssim_G = ((2 * muX_G * muY_G + C1) * (2 * sigmaXY_G + C2)) / 
-                   ((muX_G * muX_G + muY_G * muY_G + C1) * (sigmaX2_G + sigmaY2_G + C2));
-                   
-    double ssim_B = ((2 * muX_B * muY_B + C1) * (2 * sigmaXY_B + C2)) / 
-                   ((muX_B * muX_B + muY_B * muY_B + C1) * (sigmaX2_B + sigmaY2_B + C2));
+    if (withHistogram) {
+        std::fill(&stats.histogram[0][0], &stats.histogram[0][0] + 3 * 256, 0);
+    }
     
-    double ssim = wR * ssim_R + wG * ssim_G + wB * ssim_B;
+    if (image.isGrayscale()) {
+        for (int j = y; j < y + height; j++) {
+            const BYTE* row = image.row(0, j);
+            
+            for (int i = x; i < x + width; i++) {
+                BYTE value = row[i];
+                stats.sum[0] += value;
+                stats.sumSq[0] += static_cast<unsigned long long>(value) * value;
+                stats.minValue[0] = std::min(stats.minValue[0], value);
+                stats.maxValue[0] = std::max(stats.maxValue[0], value);
+                
+                if (withHistogram) {
+                    stats.histogram[0][value]++;
+                }
+                
+                stats.pixelCount++;
+            }
+        }
+        
+        if (stats.pixelCount > 0) {
+            BYTE gray = static_cast<BYTE>(stats.sum[0] / stats.pixelCount);
+            stats.avgColor.rgbRed = stats.avgColor.rgbGreen = stats.avgColor.rgbBlue = gray;
+        }
+        
+        return stats;
+    }
     
-    // SSIM berkisar dari 0 hingga 1, dengan 1 menunjukkan kesamaan sempurna
-    // Untuk kompresi quadtree, nilai error yang tinggi = kurang mirip
-    const double SCALE_FACTOR = 10000.0;
+    for (int j = y; j < y + height; j++) {
+        const BYTE* rowR = image.row(0, j);
+        const BYTE* rowG = image.row(1, j);
+        const BYTE* rowB = image.row(2, j);
+        
+        for (int i = x; i < x + width; i++) {
+            BYTE values[3] = {rowR[i], rowG[i], rowB[i]};
+            
+            for (int c = 0; c < 3; c++) {
+                stats.sum[c] += values[c];
+                stats.sumSq[c] += static_cast<unsigned long long>(values[c]) * values[c];
+                stats.minValue[c] = std::min(stats.minValue[c], values[c]);
+                stats.maxValue[c] = std::max(stats.maxValue[c], values[c]);
+            }
+            
+            if (withHistogram) {
+                stats.histogram[0][values[0]]++;
+                stats.histogram[1][values[1]]++;
+                stats.histogram[2][values[2]]++;
+            }
+            
+            stats.pixelCount++;
+        }
+    }
     
-    // Jika ssim mendekati 1 (sangat mirip), maka error akan mendekati 0
-    double error = (1.0 - ssim) * SCALE_FACTOR;
+    if (stats.pixelCount > 0) {
+        stats.avgColor.rgbRed = static_cast<BYTE>(stats.sum[0] / stats.pixelCount);
+        stats.avgColor.rgbGreen = static_cast<BYTE>(stats.sum[1] / stats.pixelCount);
+        stats.avgColor.rgbBlue = static_cast<BYTE>(stats.sum[2] / stats.pixelCount);
+    }
     
-    return error;
+    return stats;
 }
 
-// Fungsi untuk memilih metode error dan memanggil fungsinya
-double calculateError(FIBITMAP* image, int x, int y, int width, int height, int method) {
-    RGBQUAD avgColor = calculateAverageColor(image, x, y, width, height);
+// Metode yang membutuhkan histogram: MAD (deviasi dihitung per nilai) dan Entropy
+bool errorMethodNeedsHistogram(int method) {
+    return method == 2 || method == 4;
+}
+
+// Fungsi untuk menghitung error dari statistik blok tanpa scan ulang pixel
+double calculateError(const BlockStats& stats, int method) {
+    unsigned long long N = stats.pixelCount;
+    BYTE avg[3] = {stats.avgColor.rgbRed, stats.avgColor.rgbGreen, stats.avgColor.rgbBlue};
+    double channelError[3] = {0, 0, 0};
+    
+    if (N == 0) return 0;
     
     switch (method) {
-        case 1: 
-            return calculateVariance(image, x, y, width, height, avgColor);
-        case 2: 
-            return calculateMAD(image, x, y, width, height, avgColor);
-        case 3:
-            return calculateMaxDifference(image, x, y, width, height);
-        case 4:
-            return calculateEntropy(image, x, y, width, height);
-        case 5:
-            return calculateSSIM(image, x, y, width, height, avgColor);
-        default:
-            return calculateVariance(image, x, y, width, height, avgColor);
+        case 2: {
+            // MAD: Sum(|p - avg|) = Sum(histogram[v] * |v - avg|)
+            for (int c = 0; c < stats.channels; c++) {
+                unsigned long long deviation = 0;
+                for (int v = 0; v < 256; v++) {
+                    deviation += static_cast<unsigned long long>(stats.histogram[c][v]) * std::abs(v - avg[c]);
+                }
+                channelError[c] = static_cast<double>(deviation) / N;
+            }
+            return averageChannelError(channelError, stats.channels);
+        }
+        case 3: {
+            for (int c = 0; c < stats.channels; c++) {
+                channelError[c] = stats.maxValue[c] - stats.minValue[c];
+            }
+            return averageChannelError(channelError, stats.channels);
+        }
+        case 4: {
+            for (int c = 0; c < stats.channels; c++) {
+                channelError[c] = calculateHistogramEntropy(stats.histogram[c], N);
+            }
+            return averageChannelError(channelError, stats.channels);
+        }
+        case 5: {
+            double muX[3] = {0, 0, 0}, sigmaX2[3] = {0, 0, 0};
+            for (int c = 0; c < stats.channels; c++) {
+                muX[c] = static_cast<double>(stats.sum[c]) / N;
+                sigmaX2[c] = channelCentralMoment(stats.sum[c], stats.sumSq[c], N) / N;
+            }
+            return ssimErrorFromMoments(muX, sigmaX2, stats.avgColor, stats.channels);
+        }
+        default: {
+            for (int c = 0; c < stats.channels; c++) {
+                channelError[c] = channelSquaredDeviation(stats.sum[c], stats.sumSq[c], N, avg[c]) / N;
+            }
+            return averageChannelError(channelError, stats.channels);
+        }
     }
 }
 
+// Fungsi untuk memilih metode error dan memanggil fungsinya
+double calculateError(const ImageView& image, int x, int y, int width, int height, int method) {
+    BlockStats stats = calculateBlockStats(image, x, y, width, height, errorMethodNeedsHistogram(method));
+    
+    return calculateError(stats, method);
+}
+
 // Fungsi untuk mendapatkan nama metode pengukuran error
 const char* getErrorMethodName(int method) {
     switch (method) {
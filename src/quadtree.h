@@ -6,50 +6,154 @@
 #include "FreeImage.h"
 
 // Struktur Node Quadtree
+// Node disimpan berurutan di dalam QuadTree::nodes. Keempat anak sebuah node selalu
+// bersebelahan (kiri atas, kanan atas, kiri bawah, kanan bawah) sehingga cukup
+// disimpan indeks anak pertamanya.
 struct QuadTreeNode {
     int x, y;               // Posisi (koordinat kiri atas)
     int width, height;      // Ukuran blok
     RGBQUAD avgColor;       // Warna rata-rata blok
-    bool isLeaf;            // Flag untuk node daun
+    int firstChild;         // Indeks anak pertama, -1 untuk node daun
     
-    // Child nodes (untuk non-leaf)
-    QuadTreeNode* topLeft;
-    QuadTreeNode* topRight;
-    QuadTreeNode* bottomLeft;
-    QuadTreeNode* bottomRight;
+    bool isLeaf() const { return firstChild < 0; }
+};
+
+// Quadtree dengan seluruh node di dalam satu array, nodes[0] adalah akar.
+// Memori seluruh pohon dibebaskan sekaligus, tanpa delete per node.
+struct QuadTree {
+    std::vector<QuadTreeNode> nodes;
+    
+    const QuadTreeNode& root() const { return nodes[0]; }
+    const QuadTreeNode& child(const QuadTreeNode& node, int quadrant) const {
+        return nodes[node.firstChild + quadrant];
+    }
+    
+    void clear() { std::vector<QuadTreeNode>().swap(nodes); }
+};
+
+// Fungsi untuk mengelola node pada QuadTree
+int addQuadTreeNode(QuadTree& tree, int x, int y, int width, int height);
+int splitQuadTreeNode(QuadTree& tree, int index);
+bool canSplitQuadTreeBlock(int width, int height, int minBlockSize);
+
+// Salinan pixel gambar dalam bentuk planar (satu array per channel) agar kernel
+// membaca baris secara berurutan tanpa memanggil FreeImage untuk setiap pixel.
+// Baris ke-j sama dengan scanline ke-j pada FreeImage (urutan bawah ke atas).
+struct ImageView {
+    int width, height;
+    int channels;                       // 3, atau 1 untuk grayscale (R = G = B)
+    std::vector<BYTE> planes[3];        // Channel R, G, B, masing-masing width * height
+                                        // (grayscale hanya planes[0])
+    
+    bool isGrayscale() const { return channels == 1; }
+    
+    // Gambar grayscale mengembalikan planes[0] untuk ketiga channel
+    const BYTE* row(int channel, int j) const {
+        return planes[channels == 1 ? 0 : channel].data() + static_cast<size_t>(j) * width;
+    }
     
-    // Constructor
-    QuadTreeNode(int _x, int _y, int _width, int _height);
+    BYTE* row(int channel, int j) {
+        return planes[channels == 1 ? 0 : channel].data() + static_cast<size_t>(j) * width;
+    }
+};
+
+// Fungsi untuk konversi antara bitmap FreeImage dan ImageView. Bitmap 8 bit grayscale,
+// 8 bit palet, 24 bit dan 32 bit dibaca langsung; format lain dikonversi ke 24 bit dulu
+ImageView createImageView(FIBITMAP* image);
+ImageView createImageView(int width, int height, int channels = 3);
+FIBITMAP* createBitmapFromView(const ImageView& view);
+void fillRectangle(ImageView& view, int x, int y, int width, int height, RGBQUAD color);
+
+// Integral image (summed-area table) per channel, dibangun sekali per gambar
+// sehingga rata-rata warna dan variance sembarang blok dapat dihitung dalam O(1)
+struct IntegralImage {
+    int width, height;
+    int channels;                                      // Sama dengan ImageView asalnya
     
-    // Destructor
-    ~QuadTreeNode();
+    // Ukuran (width + 1) * (height + 1), baris dan kolom pertama bernilai 0.
+    // Untuk gambar grayscale hanya sumR dan sqR yang diisi
+    std::vector<unsigned long long> sumR, sumG, sumB;  // Jumlah nilai pixel
+    std::vector<unsigned long long> sqR, sqG, sqB;     // Jumlah kuadrat nilai pixel
 };
 
+// Fungsi untuk membangun integral image
+IntegralImage buildIntegralImage(const ImageView& image);
+
+// Statistik sebuah blok yang dikumpulkan dalam satu kali scan pixel
+struct BlockStats {
+    int pixelCount;
+    int channels;                       // 1 untuk grayscale: hanya indeks 0 yang diisi
+    RGBQUAD avgColor;                   // Rata-rata warna (pembagian integer)
+    unsigned long long sum[3];          // Jumlah nilai per channel (R, G, B)
+    unsigned long long sumSq[3];        // Jumlah kuadrat nilai per channel
+    BYTE minValue[3], maxValue[3];      // Nilai minimum dan maksimum per channel
+    bool hasHistogram;
+    int histogram[3][256];              // Hanya diisi jika diminta (MAD dan Entropy)
+};
+
+// Fungsi untuk merata-ratakan error ketiga channel. Untuk gambar grayscale hanya channelError[0]
+// yang dihitung dan disalin ke G dan B, sehingga hasilnya identik dengan perhitungan RGB
+double averageChannelError(double channelError[3], int channels);
+
+// Fungsi untuk mengumpulkan statistik blok
+BlockStats calculateBlockStats(const ImageView& image, int x, int y, int width, int height, bool withHistogram);
+bool errorMethodNeedsHistogram(int method);
+double calculateError(const BlockStats& stats, int method);
+
 // Fungsi untuk perhitungan warna dan error
-RGBQUAD calculateAverageColor(FIBITMAP* image, int x, int y, int width, int height);
-double calculateVariance(FIBITMAP* image, int x, int y, int width, int height, RGBQUAD avgColor);
-double calculateMAD(FIBITMAP* image, int x, int y, int width, int height, RGBQUAD avgColor);
-double calculateMaxDifference(FIBITMAP* image, int x, int y, int width, int height);
-double calculateEntropy(FIBITMAP* image, int x, int y, int width, int height);
-double calculateSSIM(FIBITMAP* image, int x, int y, int width, int height, RGBQUAD avgColor);
-double calculateError(FIBITMAP* image, int x, int y, int width, int height, int method);
+RGBQUAD calculateAverageColor(const ImageView& image, int x, int y, int width, int height);
+double calculateVariance(const ImageView& image, int x, int y, int width, int height, RGBQUAD avgColor);
+double calculateMAD(const ImageView& image, int x, int y, int width, int height, RGBQUAD avgColor);
+double calculateMaxDifference(const ImageView& image, int x, int y, int width, int height);
+double calculateEntropy(const ImageView& image, int x, int y, int width, int height);
+double calculateHistogramEntropy(const int histogram[256], unsigned long long pixelCount);
+double calculateSSIM(const ImageView& image, int x, int y, int width, int height, RGBQUAD avgColor);
+double calculateError(const ImageView& image, int x, int y, int width, int height, int method);
+
+// Versi O(1) berbasis integral image
+RGBQUAD calculateAverageColor(const IntegralImage& integral, int x, int y, int width, int height);
+double calculateVariance(const IntegralImage& integral, int x, int y, int width, int height, RGBQUAD avgColor);
+double calculateSSIM(const IntegralImage& integral, int x, int y, int width, int height, RGBQUAD avgColor);
 
 // Fungsi untuk pembangunan dan visualisasi Quadtree
-QuadTreeNode* buildQuadTree(FIBITMAP* image, int x, int y, int width, int height, 
-                            int minBlockSize, double threshold, int method);
-void drawQuadTree(FIBITMAP* outputImage, QuadTreeNode* node);
-void calculateQuadTreeStats(QuadTreeNode* node, int& nodeCount, int& maxDepth, int currentDepth = 0);
-double calculateCompressionPercentage(FIBITMAP* originalImage, int nodeCount);
-int getQuadTreeDepth(QuadTreeNode* node);
+QuadTree buildQuadTree(const ImageView& image, int x, int y, int width, int height, 
+                       int minBlockSize, double threshold, int method);
+QuadTree buildQuadTree(const ImageView& image, const IntegralImage& integral, int x, int y, int width, int height, 
+                       int minBlockSize, double threshold, int method);
+QuadTree buildQuadTreeParallel(const ImageView& image, const IntegralImage& integral, int x, int y, int width, int height, 
+                               int minBlockSize, double threshold, int method, int threadCount);
+void drawQuadTree(ImageView& outputImage, const QuadTree& tree);
+void drawQuadTreeRegion(ImageView& outputImage, const QuadTree& tree, 
+                        int regionX, int regionY, int regionWidth, int regionHeight);
+unsigned long long calculateCompressedSize(int nodeCount);
+double calculateCompressionPercentage(const ImageView& originalImage, int nodeCount);
+int getQuadTreeDepth(const QuadTree& tree);
 
-// Fungsi untuk mencari threshold optimal
-double findThresholdForTargetCompression(FIBITMAP* image, int minBlockSize, int method, double targetPercentage);
+// Pohon penuh hingga minBlockSize beserta error tiap node, dibangun sekali agar
+// jumlah node pada threshold berapa pun dapat dijawab tanpa membaca pixel lagi
+struct FullQuadTree {
+    QuadTree tree;                  // Semua node yang ukurannya masih bisa dibagi ikut dibagi
+    std::vector<double> errors;     // Error tiap node internal (indeks sama dengan tree.nodes)
+    std::vector<double> splitKeys;  // Error minimum sepanjang jalur akar-node internal, terurut naik
+};
+
+// Fungsi untuk pohon penuh dan pemangkasan berdasarkan threshold
+FullQuadTree buildFullQuadTree(const ImageView& image, const IntegralImage& integral, int minBlockSize, int method);
+int countQuadTreeNodes(const FullQuadTree& full, double threshold);
+QuadTree pruneQuadTree(const FullQuadTree& full, double threshold);
 
-// Fungsi untuk membuat dan menyimpan GIF menggunakan FreeImage
-std::vector<FIBITMAP*> createQuadTreeFrames(FIBITMAP* image, QuadTreeNode* root);
+// Fungsi untuk membangun Quadtree dengan batas jumlah node (error terbesar dibagi lebih dulu)
+QuadTree buildQuadTreeWithBudget(const ImageView& image, const IntegralImage& integral, 
+                                 int minBlockSize, int method, int maxNodes);
+int calculateNodeBudget(unsigned long long maxBytes);
+
+// Fungsi untuk mencari threshold optimal
+double findThresholdForTargetCompression(const ImageView& image, int minBlockSize, int method, double targetPercentage);
+double findThresholdForTargetCompression(const FullQuadTree& full, const ImageView& image, double targetPercentage);
 
-// Fungsi untuk membuat dan menyimpan GIF menggunakan ImageMagick
-bool saveGIF(FIBITMAP* originalImage, QuadTreeNode* root, const std::string& outputPath, bool useMagickExe = false);
+// Fungsi untuk membuat dan menyimpan GIF proses pembentukan quadtree (encoder GIF bawaan),
+// frame di-render dan di-encode paralel jika threadCount > 1
+bool saveGIF(const QuadTree& tree, const std::string& outputPath, int threadCount = 1);
 
 // Metode utk pengukuran error
 const char* getErrorMethodName(int method);
@@ -1,92 +1,438 @@
 #include "quadtree.h"
+#include "thread_pool.h"
 #include <functional>
 #include <cmath>
 #include <iostream>
 #include <algorithm>
+#include <limits>
+#include <queue>
 
-QuadTreeNode* buildQuadTree(FIBITMAP* image, int x, int y, int width, int height, 
-                          int minBlockSize, double threshold, int method) {
-    QuadTreeNode* node = new QuadTreeNode(x, y, width, height);
+QuadTree buildQuadTree(const ImageView& image, int x, int y, int width, int height, 
+                       int minBlockSize, double threshold, int method) {
+    IntegralImage integral = buildIntegralImage(image);
     
-    node->avgColor = calculateAverageColor(image, x, y, width, height);
+    return buildQuadTree(image, integral, x, y, width, height, minBlockSize, threshold, method);
+}
+
+// Blok dengan jumlah pixel di bawah batas ini dibangun serial di thread yang sama,
+// karena overhead task lebih besar daripada pekerjaannya
+static const long long PARALLEL_CUTOFF_PIXELS = 64 * 64;
+
+// Fungsi untuk menghitung error blok sebuah node yang warna rata-ratanya sudah diisi
+static double calculateNodeError(const QuadTreeNode& node, const ImageView& image, const IntegralImage& integral,
+                                 int method) {
+    // Variance (juga metode default) dan SSIM cukup memakai integral image, MAD dan Max Pixel
+    // Difference memakai kernel baris SIMD, Entropy dihitung dari histogram satu kali scan blok
+    // (pembangunan berbasis threshold memakai versi dari bawah ke atas, lihat buildEntropySubtree)
+    if (method < 2 || method > 5) {
+        return calculateVariance(integral, node.x, node.y, node.width, node.height, node.avgColor);
+    }
+    if (method == 5) {
+        return calculateSSIM(integral, node.x, node.y, node.width, node.height, node.avgColor);
+    }
+    if (method == 2) {
+        return calculateMAD(image, node.x, node.y, node.width, node.height, node.avgColor);
+    }
+    if (method == 3) {
+        return calculateMaxDifference(image, node.x, node.y, node.width, node.height);
+    }
     
-    double error = calculateError(image, x, y, width, height, method);
+    return calculateEntropy(image, node.x, node.y, node.width, node.height);
+}
+
+// Fungsi untuk mengecek apakah ukuran blok masih boleh dibagi
+static bool canSplitNode(const QuadTreeNode& node, int minBlockSize) {
+    return canSplitQuadTreeBlock(node.width, node.height, minBlockSize);
+}
+
+// Fungsi untuk menghitung warna rata-rata node, lalu menentukan apakah node menjadi daun
+static bool evaluateNode(QuadTreeNode& node, const ImageView& image, const IntegralImage& integral,
+                         int minBlockSize, double threshold, int method) {
+    node.avgColor = calculateAverageColor(integral, node.x, node.y, node.width, node.height);
     
     // Cek kondisi penghentian:
-    // 1. Jika error di bawah threshold, blok tidak perlu dibagi lagi
-    // 2. Jika ukuran blok sudah minimum, blok tidak bisa dibagi lagi
-    // 3. Jika ukuran blok setelah dibagi akan lebih kecil dari minimum, blok tidak dibagi
-    if (error <= threshold || width <= minBlockSize || height <= minBlockSize || 
-        width/2 < minBlockSize || height/2 < minBlockSize) {
-        node->isLeaf = true;
-        return node;
+    // 1. Jika ukuran blok sudah minimum, blok tidak bisa dibagi lagi
+    // 2. Jika ukuran blok setelah dibagi akan lebih kecil dari minimum, blok tidak dibagi
+    // 3. Jika error di bawah threshold, blok tidak perlu dibagi lagi
+    // Ukuran dicek lebih dulu sehingga error blok terkecil tidak perlu dihitung
+    if (!canSplitNode(node, minBlockSize)) {
+        return true;
+    }
+    
+    return calculateNodeError(node, image, integral, method) <= threshold;
+}
+
+// Rekursi pembangunan subtree untuk node yang sudah ada di dalam tree
+static void buildSubtree(QuadTree& tree, int index, const ImageView& image, const IntegralImage& integral,
+                         int minBlockSize, double threshold, int method) {
+    if (evaluateNode(tree.nodes[index], image, integral, minBlockSize, threshold, method)) {
+        return;
     }
     
     // Divide: Bagi blok menjadi 4 bagian
-    int halfWidth = width / 2;
-    int halfHeight = height / 2;
+    int first = splitQuadTreeNode(tree, index);
     
     // Conquer: Rekursif untuk keempat kuadran
-    node->topLeft = buildQuadTree(image, x, y, halfWidth, halfHeight, 
-                                minBlockSize, threshold, method);
+    for (int quadrant = 0; quadrant < 4; quadrant++) {
+        buildSubtree(tree, first + quadrant, image, integral, minBlockSize, threshold, method);
+    }
+}
+
+// Histogram tiga channel untuk pembangunan Entropy dari bawah ke atas (gambar grayscale
+// hanya memakai counts[0])
+struct ChannelHistogram {
+    int counts[3][256];
+};
+
+// Blok yang lebih kecil dari batas ini lebih murah discan langsung (3 * N operasi)
+// daripada menjumlahkan histogram keempat anaknya (3 * 256 operasi)
+static const long long ENTROPY_MERGE_CUTOFF_PIXELS = 256;
+
+// Fungsi untuk mengisi histogram blok dengan membaca pixel secara langsung
+static void scanHistogram(const ImageView& image, const QuadTreeNode& node, ChannelHistogram& histogram) {
+    std::fill(&histogram.counts[0][0], &histogram.counts[0][0] + image.channels * 256, 0);
     
-    node->topRight = buildQuadTree(image, x + halfWidth, y, width - halfWidth, 
-                                 halfHeight, minBlockSize, threshold, method);
+    for (int c = 0; c < image.channels; c++) {
+        for (int j = node.y; j < node.y + node.height; j++) {
+            const BYTE* row = image.row(c, j);
+            for (int i = node.x; i < node.x + node.width; i++) {
+                histogram.counts[c][row[i]]++;
+            }
+        }
+    }
+}
+
+// Fungsi untuk menghitung Entropy node dari histogramnya
+static double histogramEntropy(const ChannelHistogram& histogram, const QuadTreeNode& node, int channels) {
+    unsigned long long N = static_cast<unsigned long long>(node.width) * node.height;
+    
+    double entropy[3] = {0, 0, 0};
+    for (int c = 0; c < channels; c++) {
+        entropy[c] = calculateHistogramEntropy(histogram.counts[c], N);
+    }
+    
+    return averageChannelError(entropy, channels);
+}
+
+// Fungsi untuk menjumlahkan histogram keempat anak menjadi histogram induk
+static void mergeHistograms(const ChannelHistogram children[4], ChannelHistogram& histogram, int channels) {
+    for (int c = 0; c < channels; c++) {
+        for (int v = 0; v < 256; v++) {
+            histogram.counts[c][v] = children[0].counts[c][v] + children[1].counts[c][v] + 
+                                     children[2].counts[c][v] + children[3].counts[c][v];
+        }
+    }
+}
+
+// Rekursi pembangunan Entropy dari bawah ke atas. Untuk blok besar, error node dihitung setelah
+// anak-anaknya dan histogram induk adalah jumlah histogram anak, sehingga pixel tidak dibaca
+// ulang di tiap level; jika error ternyata <= threshold, subtree anak (selalu berada di akhir
+// array) dibuang lagi. Blok kecil dihitung langsung lalu dibagi dari atas ke bawah seperti biasa.
+// Histogram node ditulis ke parameter histogram jika needHistogram bernilai true.
+static void buildEntropySubtree(FullQuadTree& full, int index, const ImageView& image, const IntegralImage& integral,
+                                int minBlockSize, double threshold, bool needHistogram, ChannelHistogram& histogram) {
+    QuadTreeNode& node = full.tree.nodes[index];
+    node.avgColor = calculateAverageColor(integral, node.x, node.y, node.width, node.height);
     
-    node->bottomLeft = buildQuadTree(image, x, y + halfHeight, halfWidth, 
-                                   height - halfHeight, minBlockSize, threshold, method);
+    if (!canSplitNode(node, minBlockSize)) {
+        if (needHistogram) {
+            scanHistogram(image, node, histogram);
+        }
+        return;
+    }
     
-    node->bottomRight = buildQuadTree(image, x + halfWidth, y + halfHeight, 
-                                    width - halfWidth, height - halfHeight, 
-                                    minBlockSize, threshold, method);
+    if (static_cast<long long>(node.width) * node.height < ENTROPY_MERGE_CUTOFF_PIXELS) {
+        double error;
+        if (needHistogram) {
+            scanHistogram(image, node, histogram);
+            error = histogramEntropy(histogram, node, image.channels);
+        } else {
+            error = calculateEntropy(image, node.x, node.y, node.width, node.height);
+        }
+        
+        full.errors[index] = error;
+        if (error <= threshold) {
+            return;
+        }
+        
+        int first = splitQuadTreeNode(full.tree, index);
+        full.errors.resize(full.tree.nodes.size(), 0.0);
+        
+        // Histogram anak tidak dibutuhkan, parameter histogram hanya dipakai sebagai tempat
+        for (int quadrant = 0; quadrant < 4; quadrant++) {
+            buildEntropySubtree(full, first + quadrant, image, integral, minBlockSize, threshold, false, histogram);
+        }
+        return;
+    }
+    
+    int first = splitQuadTreeNode(full.tree, index);
+    full.errors.resize(full.tree.nodes.size(), 0.0);
+    
+    // Histogram anak (4 x 3 KB per channel) di heap agar stack tidak tumbuh 12 KB per level
+    std::vector<ChannelHistogram> children(4);
+    for (int quadrant = 0; quadrant < 4; quadrant++) {
+        buildEntropySubtree(full, first + quadrant, image, integral, minBlockSize, threshold, true, children[quadrant]);
+    }
     
-    return node;
+    mergeHistograms(children.data(), histogram, image.channels);
+    full.errors[index] = histogramEntropy(histogram, full.tree.nodes[index], image.channels);
+    
+    if (full.errors[index] <= threshold) {
+        full.tree.nodes.resize(first);
+        full.errors.resize(first);
+        full.tree.nodes[index].firstChild = -1;
+    }
 }
 
-// Fungsi untuk menggambar Quadtree ke gambar output
-void drawQuadTree(FIBITMAP* outputImage, QuadTreeNode* node) {
-    if (!node) return;
+// Fungsi untuk membangun tree Entropy untuk satu region. Dengan threshold -infinity
+// tidak ada node yang dipangkas sehingga hasilnya pohon penuh hingga minBlockSize
+static FullQuadTree buildEntropyTree(const ImageView& image, const IntegralImage& integral, 
+                                     int x, int y, int width, int height, int minBlockSize, double threshold) {
+    FullQuadTree full;
+    addQuadTreeNode(full.tree, x, y, width, height);
+    full.errors.assign(1, 0.0);
     
-    if (node->isLeaf) {
-        for (int j = node->y; j < node->y + node->height; j++) {
-            for (int i = node->x; i < node->x + node->width; i++) {
-                FreeImage_SetPixelColor(outputImage, i, j, &node->avgColor);
-            }
+    ChannelHistogram histogram;
+    buildEntropySubtree(full, 0, image, integral, minBlockSize, threshold, false, histogram);
+    
+    return full;
+}
+
+QuadTree buildQuadTree(const ImageView& image, const IntegralImage& integral, int x, int y, int width, int height, 
+                       int minBlockSize, double threshold, int method) {
+    // Entropy dibangun dari bawah ke atas, hasilnya sama dengan pembangunan dari atas ke bawah
+    if (method == 4) {
+        return buildEntropyTree(image, integral, x, y, width, height, minBlockSize, threshold).tree;
+    }
+    
+    QuadTree tree;
+    addQuadTreeNode(tree, x, y, width, height);
+    
+    buildSubtree(tree, 0, image, integral, minBlockSize, threshold, method);
+    
+    return tree;
+}
+
+// Gabungkan subtree anak ke dalam tree induk. Akar anak ke-k ditempatkan di indeks
+// firstChild + k, node lainnya disalin berurutan dengan indeks anak yang digeser,
+// sehingga susunan array sama persis dengan hasil pembangunan serial.
+static void appendSubtree(QuadTree& tree, int childIndex, const QuadTree& subtree) {
+    int offset = static_cast<int>(tree.nodes.size()) - 1;
+    
+    tree.nodes[childIndex] = subtree.nodes[0];
+    if (!subtree.nodes[0].isLeaf()) {
+        tree.nodes[childIndex].firstChild += offset;
+    }
+    
+    for (size_t i = 1; i < subtree.nodes.size(); i++) {
+        QuadTreeNode node = subtree.nodes[i];
+        if (!node.isLeaf()) {
+            node.firstChild += offset;
+        }
+        tree.nodes.push_back(node);
+    }
+}
+
+// Versi paralel: tiap kuadran dibangun ke tree terpisah, kuadran kanan atas, kiri bawah
+// dan kanan bawah menjadi task di pool, kuadran kiri atas dikerjakan langsung oleh thread ini
+static QuadTree buildQuadTreeTask(ThreadPool& pool, const ImageView& image, const IntegralImage& integral,
+                                  int x, int y, int width, int height,
+                                  int minBlockSize, double threshold, int method) {
+    if (static_cast<long long>(width) * height < PARALLEL_CUTOFF_PIXELS) {
+        return buildQuadTree(image, integral, x, y, width, height, minBlockSize, threshold, method);
+    }
+    
+    QuadTree tree;
+    addQuadTreeNode(tree, x, y, width, height);
+    
+    if (evaluateNode(tree.nodes[0], image, integral, minBlockSize, threshold, method)) {
+        return tree;
+    }
+    
+    int first = splitQuadTreeNode(tree, 0);
+    QuadTree subtrees[4];
+    
+    TaskGroup group(pool);
+    
+    for (int quadrant = 1; quadrant < 4; quadrant++) {
+        group.run([&, quadrant]() {
+            const QuadTreeNode& child = tree.nodes[first + quadrant];
+            subtrees[quadrant] = buildQuadTreeTask(pool, image, integral, child.x, child.y, child.width, 
+                                                   child.height, minBlockSize, threshold, method);
+        });
+    }
+    
+    const QuadTreeNode& topLeft = tree.nodes[first];
+    subtrees[0] = buildQuadTreeTask(pool, image, integral, topLeft.x, topLeft.y, topLeft.width, 
+                                    topLeft.height, minBlockSize, threshold, method);
+    
+    group.wait();
+    
+    for (int quadrant = 0; quadrant < 4; quadrant++) {
+        appendSubtree(tree, first + quadrant, subtrees[quadrant]);
+        subtrees[quadrant].clear();
+    }
+    
+    return tree;
+}
+
+// Versi paralel pohon penuh Entropy: keempat kuadran dibangun sebagai task lalu digabung
+// dengan susunan array yang sama seperti versi serial, histogram induk dari jumlah histogram anak
+static FullQuadTree buildEntropyTreeTask(ThreadPool& pool, const ImageView& image, const IntegralImage& integral,
+                                         int x, int y, int width, int height, int minBlockSize, double threshold,
+                                         ChannelHistogram& histogram) {
+    FullQuadTree full;
+    addQuadTreeNode(full.tree, x, y, width, height);
+    full.errors.assign(1, 0.0);
+    
+    if (static_cast<long long>(width) * height < PARALLEL_CUTOFF_PIXELS || 
+        !canSplitNode(full.tree.nodes[0], minBlockSize)) {
+        buildEntropySubtree(full, 0, image, integral, minBlockSize, threshold, true, histogram);
+        return full;
+    }
+    
+    full.tree.nodes[0].avgColor = calculateAverageColor(integral, x, y, width, height);
+    int first = splitQuadTreeNode(full.tree, 0);
+    full.errors.resize(full.tree.nodes.size(), 0.0);
+    
+    FullQuadTree subtrees[4];
+    std::vector<ChannelHistogram> children(4);
+    
+    TaskGroup group(pool);
+    
+    for (int quadrant = 1; quadrant < 4; quadrant++) {
+        group.run([&, quadrant]() {
+            const QuadTreeNode& child = full.tree.nodes[first + quadrant];
+            subtrees[quadrant] = buildEntropyTreeTask(pool, image, integral, child.x, child.y, child.width, 
+                                                      child.height, minBlockSize, threshold, children[quadrant]);
+        });
+    }
+    
+    const QuadTreeNode& topLeft = full.tree.nodes[first];
+    subtrees[0] = buildEntropyTreeTask(pool, image, integral, topLeft.x, topLeft.y, topLeft.width, 
+                                       topLeft.height, minBlockSize, threshold, children[0]);
+    
+    group.wait();
+    
+    for (int quadrant = 0; quadrant < 4; quadrant++) {
+        appendSubtree(full.tree, first + quadrant, subtrees[quadrant].tree);
+        
+        const std::vector<double>& errors = subtrees[quadrant].errors;
+        full.errors[first + quadrant] = errors[0];
+        full.errors.insert(full.errors.end(), errors.begin() + 1, errors.end());
+    }
+    
+    mergeHistograms(children.data(), histogram, image.channels);
+    full.errors[0] = histogramEntropy(histogram, full.tree.nodes[0], image.channels);
+    
+    if (full.errors[0] <= threshold) {
+        full.tree.nodes.resize(first);
+        full.errors.resize(first);
+        full.tree.nodes[0].firstChild = -1;
+    }
+    
+    return full;
+}
+
+// Fungsi untuk membangun Quadtree secara paralel, hasilnya identik dengan versi serial
+QuadTree buildQuadTreeParallel(const ImageView& image, const IntegralImage& integral, int x, int y, int width, int height, 
+                               int minBlockSize, double threshold, int method, int threadCount) {
+    if (threadCount <= 1) {
+        return buildQuadTree(image, integral, x, y, width, height, minBlockSize, threshold, method);
+    }
+    
+    ThreadPool pool(threadCount);
+    
+    if (method == 4) {
+        ChannelHistogram histogram;
+        return buildEntropyTreeTask(pool, image, integral, x, y, width, height, minBlockSize, 
+                                    threshold, histogram).tree;
+    }
+    
+    return buildQuadTreeTask(pool, image, integral, x, y, width, height, minBlockSize, threshold, method);
+}
+
+// Fungsi untuk menggambar Quadtree ke gambar output
+void drawQuadTree(ImageView& outputImage, const QuadTree& tree) {
+    // Daun-daun quadtree menutupi gambar tanpa tumpang tindih, jadi cukup satu kali
+    // iterasi linear pada array node tanpa rekursi
+    for (const QuadTreeNode& node : tree.nodes) {
+        if (node.isLeaf()) {
+            fillRectangle(outputImage, node.x, node.y, node.width, node.height, node.avgColor);
         }
-    } else {
-        // Rekursif untuk semua anak
-        drawQuadTree(outputImage, node->topLeft);
-        drawQuadTree(outputImage, node->topRight);
-        drawQuadTree(outputImage, node->bottomLeft);
-        drawQuadTree(outputImage, node->bottomRight);
     }
 }
 
-// Fungsi untuk menghitung statistik Quadtree
-void calculateQuadTreeStats(QuadTreeNode* node, int& nodeCount, int& maxDepth, int currentDepth) {
-    if (!node) return;
+// Fungsi untuk memetakan koordinat gambar asli ke koordinat kanvas output (dibulatkan ke bawah).
+// Pemetaan monoton, sehingga blok yang bersebelahan tetap bersebelahan tanpa celah di output.
+static int mapToOutput(long long coordinate, int regionStart, int regionSize, int outputSize) {
+    long long mapped = (coordinate - regionStart) * outputSize / regionSize;
+    return static_cast<int>(std::max(0LL, std::min<long long>(mapped, outputSize)));
+}
+
+// Rekursi render region: subtree di luar region dilewati, dan node yang di output tidak lebih
+// besar dari satu pixel langsung digambar dengan warna rata-ratanya tanpa turun ke anak
+static void drawRegionSubtree(ImageView& outputImage, const QuadTree& tree, int index,
+                              int regionX, int regionY, int regionWidth, int regionHeight) {
+    const QuadTreeNode& node = tree.nodes[index];
+    
+    if (node.x >= regionX + regionWidth || node.x + node.width <= regionX ||
+        node.y >= regionY + regionHeight || node.y + node.height <= regionY) {
+        return;
+    }
+    
+    int x0 = mapToOutput(node.x, regionX, regionWidth, outputImage.width);
+    int x1 = mapToOutput(static_cast<long long>(node.x) + node.width, regionX, regionWidth, outputImage.width);
+    int y0 = mapToOutput(node.y, regionY, regionHeight, outputImage.height);
+    int y1 = mapToOutput(static_cast<long long>(node.y) + node.height, regionY, regionHeight, outputImage.height);
+    
+    // Node (dan seluruh anaknya) tidak menutupi satu pun pixel output
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+    
+    bool subPixel = static_cast<long long>(node.width) * outputImage.width <= regionWidth &&
+                    static_cast<long long>(node.height) * outputImage.height <= regionHeight;
     
-    nodeCount++;
-    maxDepth = std::max(maxDepth, currentDepth);
+    if (node.isLeaf() || subPixel) {
+        fillRectangle(outputImage, x0, y0, x1 - x0, y1 - y0, node.avgColor);
+        return;
+    }
     
-    if (!node->isLeaf) {
-        calculateQuadTreeStats(node->topLeft, nodeCount, maxDepth, currentDepth + 1);
-        calculateQuadTreeStats(node->topRight, nodeCount, maxDepth, currentDepth + 1);
-        calculateQuadTreeStats(node->bottomLeft, nodeCount, maxDepth, currentDepth + 1);
-        calculateQuadTreeStats(node->bottomRight, nodeCount, maxDepth, currentDepth + 1);
+    for (int quadrant = 0; quadrant < 4; quadrant++) {
+        drawRegionSubtree(outputImage, tree, node.firstChild + quadrant, regionX, regionY, regionWidth, regionHeight);
     }
 }
 
+// Fungsi untuk menggambar sebagian Quadtree ke seluruh kanvas output. Region diberikan dalam
+// koordinat gambar asli dan diskalakan menjadi outputImage.width x outputImage.height, misalnya
+// untuk thumbnail (region = seluruh gambar, kanvas kecil) atau pratinjau tile. Bagian region
+// yang berada di luar gambar tidak diubah.
+void drawQuadTreeRegion(ImageView& outputImage, const QuadTree& tree, 
+                        int regionX, int regionY, int regionWidth, int regionHeight) {
+    if (tree.nodes.empty() || regionWidth <= 0 || regionHeight <= 0 || 
+        outputImage.width <= 0 || outputImage.height <= 0) {
+        return;
+    }
+    
+    drawRegionSubtree(outputImage, tree, 0, regionX, regionY, regionWidth, regionHeight);
+}
+
+// Fungsi untuk menghitung ukuran hasil kompresi: posisi, ukuran, warna dan flag daun per node
+unsigned long long calculateCompressedSize(int nodeCount) {
+    return static_cast<unsigned long long>(nodeCount) * 
+           (2 * sizeof(int) + 2 * sizeof(int) + sizeof(RGBQUAD) + sizeof(bool));
+}
+
 // Fungsi untuk menghitung persentase kompresi
-double calculateCompressionPercentage(FIBITMAP* originalImage, int nodeCount) {
-    int width = FreeImage_GetWidth(originalImage);
-    int height = FreeImage_GetHeight(originalImage);
+double calculateCompressionPercentage(const ImageView& originalImage, int nodeCount) {
+    int width = originalImage.width;
+    int height = originalImage.height;
     
     // Asumsi gambar RGB dimana setiap pixel membutuhkan 3 bytes
     unsigned long long originalSize = static_cast<unsigned long long>(width) * height * 3;
     
-    unsigned long long compressedSize = static_cast<unsigned long long>(nodeCount) * 
-                                      (2 * sizeof(int) + 2 * sizeof(int) + sizeof(RGBQUAD) + sizeof(bool));
+    unsigned long long compressedSize = calculateCompressedSize(nodeCount);
     
     // persentase kompresi
     double compressionPercentage = (1.0 - static_cast<double>(compressedSize) / originalSize) * 100.0;
@@ -94,41 +440,207 @@ double calculateCompressionPercentage(FIBITMAP* originalImage, int nodeCount) {
     return compressionPercentage;
 }
 
-// Fungsi untuk mencari threshold optimal untuk target persentase kompresi
-double findThresholdForTargetCompression(FIBITMAP* image, int minBlockSize, int method, double targetPercentage) {
-    double lowThreshold = 0.0;
-    double highThreshold = 100.0; 
-    double currentThreshold;
-    
-    const double TOLERANCE = 0.5; 
-    int maxIterations = 15; // Iterasi dibatasi untuk efisiensi
+// Fungsi untuk membangun Quadtree dengan batas jumlah node secara greedy: mulai dari akar,
+// daun dengan error terbesar selalu dibagi lebih dulu (max-heap) hingga batas tercapai.
+// Setiap pembagian menambah 4 node, sehingga hasilnya adalah 1 + 4k node terbesar <= maxNodes.
+QuadTree buildQuadTreeWithBudget(const ImageView& image, const IntegralImage& integral, 
+                                 int minBlockSize, int method, int maxNodes) {
+    QuadTree tree;
+    addQuadTreeNode(tree, 0, 0, image.width, image.height);
     
-    int width = FreeImage_GetWidth(image);
-    int height = FreeImage_GetHeight(image);
+    // Pasangan (error, indeks node); error sama diurutkan berdasarkan indeks terkecil
+    typedef std::pair<double, int> Candidate;
+    auto lowerPriority = [](const Candidate& a, const Candidate& b) {
+        return a.first < b.first || (a.first == b.first && a.second > b.second);
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(lowerPriority)> candidates(lowerPriority);
     
-    for (int i = 0; i < maxIterations; i++) {
-        currentThreshold = (lowThreshold + highThreshold) / 2.0;
+    auto evaluateCandidate = [&](int index) {
+        QuadTreeNode& node = tree.nodes[index];
+        node.avgColor = calculateAverageColor(integral, node.x, node.y, node.width, node.height);
         
-        QuadTreeNode* root = buildQuadTree(image, 0, 0, width, height, 
-                                          minBlockSize, currentThreshold, method);
+        if (canSplitNode(node, minBlockSize)) {
+            candidates.push(Candidate(calculateNodeError(node, image, integral, method), index));
+        }
+    };
+    
+    evaluateCandidate(0);
+    
+    while (!candidates.empty() && static_cast<long long>(tree.nodes.size()) + 4 <= maxNodes) {
+        Candidate best = candidates.top();
+        candidates.pop();
         
-        int nodeCount = 0, maxDepth = 0;
-        calculateQuadTreeStats(root, nodeCount, maxDepth);
+        // Blok yang sudah seragam tidak menambah kualitas jika dibagi
+        if (best.first <= 0) {
+            break;
+        }
         
-        double compressionPercentage = calculateCompressionPercentage(image, nodeCount);
+        int first = splitQuadTreeNode(tree, best.second);
+        for (int quadrant = 0; quadrant < 4; quadrant++) {
+            evaluateCandidate(first + quadrant);
+        }
+    }
+    
+    return tree;
+}
+
+// Fungsi untuk mengubah batas ukuran hasil kompresi (bytes) menjadi batas jumlah node
+int calculateNodeBudget(unsigned long long maxBytes) {
+    unsigned long long nodeBytes = calculateCompressedSize(1);
+    unsigned long long maxNodes = maxBytes / nodeBytes;
+    
+    return static_cast<int>(std::min<unsigned long long>(maxNodes, std::numeric_limits<int>::max()));
+}
+
+// Rekursi pembangunan pohon penuh; pathKey adalah error minimum para leluhur node
+static void buildFullSubtree(FullQuadTree& full, int index, double pathKey, const ImageView& image, 
+                             const IntegralImage& integral, int minBlockSize, int method) {
+    QuadTreeNode& node = full.tree.nodes[index];
+    node.avgColor = calculateAverageColor(integral, node.x, node.y, node.width, node.height);
+    
+    if (!canSplitNode(node, minBlockSize)) {
+        return;
+    }
+    
+    // Node dibagi pada threshold T jika dan hanya jika semua leluhurnya dan node itu
+    // sendiri punya error > T, jadi kuncinya adalah error minimum sepanjang jalur
+    double error = calculateNodeError(node, image, integral, method);
+    double key = std::min(pathKey, error);
+    
+    full.errors[index] = error;
+    full.splitKeys.push_back(key);
+    
+    int first = splitQuadTreeNode(full.tree, index);
+    full.errors.resize(full.tree.nodes.size(), 0.0);
+    
+    for (int quadrant = 0; quadrant < 4; quadrant++) {
+        buildFullSubtree(full, first + quadrant, key, image, integral, minBlockSize, method);
+    }
+}
+
+// Fungsi untuk mengisi dan mengurutkan kunci pembagian dari error yang sudah dihitung. Anak
+// selalu disimpan setelah induknya, jadi satu iterasi maju cukup untuk meneruskan error minimum jalur
+static void collectSplitKeys(FullQuadTree& full) {
+    std::vector<double> pathKeys(full.tree.nodes.size(), std::numeric_limits<double>::infinity());
+    
+    for (size_t i = 0; i < full.tree.nodes.size(); i++) {
+        const QuadTreeNode& node = full.tree.nodes[i];
+        if (node.isLeaf()) continue;
         
-        delete root;
+        double key = std::min(pathKeys[i], full.errors[i]);
+        full.splitKeys.push_back(key);
         
-        if (fabs(compressionPercentage - targetPercentage) < TOLERANCE) {
-            return currentThreshold;
+        for (int quadrant = 0; quadrant < 4; quadrant++) {
+            pathKeys[node.firstChild + quadrant] = key;
         }
-        
-        if (compressionPercentage < targetPercentage) {
-            lowThreshold = currentThreshold;
+    }
+    
+    std::sort(full.splitKeys.begin(), full.splitKeys.end());
+}
+
+// Fungsi untuk membangun pohon penuh hingga minBlockSize beserta error tiap node
+FullQuadTree buildFullQuadTree(const ImageView& image, const IntegralImage& integral, int minBlockSize, int method) {
+    if (method == 4) {
+        FullQuadTree full = buildEntropyTree(image, integral, 0, 0, image.width, image.height, minBlockSize, 
+                                             -std::numeric_limits<double>::infinity());
+        collectSplitKeys(full);
+        return full;
+    }
+    
+    FullQuadTree full;
+    addQuadTreeNode(full.tree, 0, 0, image.width, image.height);
+    full.errors.assign(1, 0.0);
+    
+    buildFullSubtree(full, 0, std::numeric_limits<double>::infinity(), image, integral, minBlockSize, method);
+    
+    std::sort(full.splitKeys.begin(), full.splitKeys.end());
+    
+    return full;
+}
+
+// Fungsi untuk menghitung jumlah node pada threshold tertentu dalam O(log n)
+int countQuadTreeNodes(const FullQuadTree& full, double threshold) {
+    // Setiap pembagian menambah 4 node; yang dibagi adalah node dengan kunci > threshold
+    long long splitCount = full.splitKeys.end() - 
+                           std::upper_bound(full.splitKeys.begin(), full.splitKeys.end(), threshold);
+    
+    return static_cast<int>(1 + 4 * splitCount);
+}
+
+// Rekursi pemangkasan: salin node dari pohon penuh selama error-nya di atas threshold
+static void pruneSubtree(const FullQuadTree& full, int source, QuadTree& tree, int target, double threshold) {
+    const QuadTreeNode& node = full.tree.nodes[source];
+    if (node.isLeaf() || full.errors[source] <= threshold) {
+        return;
+    }
+    
+    int first = splitQuadTreeNode(tree, target);
+    
+    for (int quadrant = 0; quadrant < 4; quadrant++) {
+        tree.nodes[first + quadrant].avgColor = full.tree.nodes[node.firstChild + quadrant].avgColor;
+        pruneSubtree(full, node.firstChild + quadrant, tree, first + quadrant, threshold);
+    }
+}
+
+// Fungsi untuk memangkas pohon penuh pada threshold tertentu tanpa membaca pixel lagi,
+// hasilnya identik dengan buildQuadTree pada threshold yang sama
+QuadTree pruneQuadTree(const FullQuadTree& full, double threshold) {
+    QuadTree tree;
+    const QuadTreeNode& root = full.tree.root();
+    
+    addQuadTreeNode(tree, root.x, root.y, root.width, root.height);
+    tree.nodes[0].avgColor = root.avgColor;
+    
+    pruneSubtree(full, 0, tree, 0, threshold);
+    
+    return tree;
+}
+
+// Fungsi untuk mencari threshold optimal untuk target persentase kompresi dari pohon penuh.
+// Persentase kompresi naik seiring threshold, sehingga cukup binary search pada kunci
+// yang sudah terurut untuk menemukan threshold dengan persentase terdekat ke target.
+double findThresholdForTargetCompression(const FullQuadTree& full, const ImageView& image, double targetPercentage) {
+    const std::vector<double>& keys = full.splitKeys;
+    if (keys.empty()) {
+        return 0.0;
+    }
+    
+    auto compressionAt = [&](double threshold) {
+        return calculateCompressionPercentage(image, countQuadTreeNodes(full, threshold));
+    };
+    
+    // Cari kunci terkecil yang persentase kompresinya sudah mencapai target
+    size_t low = 0, high = keys.size();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (compressionAt(keys[mid]) >= targetPercentage) {
+            high = mid;
         } else {
-            highThreshold = currentThreshold;
+            low = mid + 1;
         }
     }
+    
+    if (low == keys.size()) {
+        // Target tidak tercapai bahkan dengan satu node, pakai kompresi maksimum
+        return keys.back();
+    }
+    
+    // Bandingkan dengan kandidat di bawahnya (kunci sebelumnya, atau 0 untuk kunci pertama)
+    double upper = keys[low];
+    double lower = low > 0 ? keys[low - 1] : std::min(0.0, upper);
+    
+    if (fabs(compressionAt(lower) - targetPercentage) <= fabs(compressionAt(upper) - targetPercentage)) {
+        return lower;
+    }
+    
+    return upper;
+}
 
-    return currentThreshold;
-}
\ No newline at end of file
+// Fungsi untuk mencari threshold optimal untuk target persentase kompresi
+double findThresholdForTargetCompression(const ImageView& image, int minBlockSize, int method, double targetPercentage) {
+    // Pohon penuh cukup dibangun sekali, setiap threshold kandidat dijawab dengan pemangkasan
+    IntegralImage integral = buildIntegralImage(image);
+    FullQuadTree full = buildFullQuadTree(image, integral, minBlockSize, method);
+    
+    return findThresholdForTargetCompression(full, image, targetPercentage);
+}
@@ -0,0 +1,242 @@
+#include "simd_kernels.h"
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define QUADTREE_HAS_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// ===== Versi skalar (fallback dan acuan) =====
+
+static unsigned long long squaredDeviationScalar(const BYTE* row, int count, BYTE avg) {
+    unsigned long long total = 0;
+    for (int i = 0; i < count; i++) {
+        int diff = static_cast<int>(row[i]) - avg;
+        total += static_cast<unsigned long long>(diff * diff);
+    }
+    return total;
+}
+
+static unsigned long long absoluteDeviationScalar(const BYTE* row, int count, BYTE avg) {
+    unsigned long long total = 0;
+    for (int i = 0; i < count; i++) {
+        total += static_cast<unsigned long long>(abs(static_cast<int>(row[i]) - avg));
+    }
+    return total;
+}
+
+static void minMaxScalar(const BYTE* row, int count, BYTE& minValue, BYTE& maxValue) {
+    for (int i = 0; i < count; i++) {
+        minValue = std::min(minValue, row[i]);
+        maxValue = std::max(maxValue, row[i]);
+    }
+}
+
+#ifdef QUADTREE_HAS_X86_SIMD
+
+// Setiap lane hasil madd bernilai paling banyak 2 * 255^2, dan setiap iterasi menambahkan dua
+// hasil madd, sehingga satu lane akumulator 32 bit bertambah paling banyak 4 * 255^2 per
+// iterasi. Setelah 8192 iterasi nilainya paling banyak sekitar 2.13e9: melewati batas int32
+// tetapi masih di bawah 2^32, jadi lane dibaca sebagai unsigned saat dikosongkan ke akumulator
+// 64 bit (penjumlahan epi32 bersifat modular sehingga bitnya tetap benar)
+static const int MADD_FLUSH_ITERATIONS = 8192;
+
+// ===== Versi SSE2 (16 pixel per iterasi) =====
+
+__attribute__((target("sse2")))
+static unsigned long long squaredDeviationSse2(const BYTE* row, int count, BYTE avg) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i average = _mm_set1_epi16(avg);
+    unsigned long long total = 0;
+    int i = 0;
+    
+    while (i + 16 <= count) {
+        __m128i accumulator = _mm_setzero_si128();
+        
+        for (int iteration = 0; iteration < MADD_FLUSH_ITERATIONS && i + 16 <= count; iteration++, i += 16) {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            
+            // Perluas ke 16 bit lalu kurangi rata-rata, selisih berada di [-255, 255]
+            __m128i low = _mm_sub_epi16(_mm_unpacklo_epi8(pixels, zero), average);
+            __m128i high = _mm_sub_epi16(_mm_unpackhi_epi8(pixels, zero), average);
+            
+            accumulator = _mm_add_epi32(accumulator, _mm_madd_epi16(low, low));
+            accumulator = _mm_add_epi32(accumulator, _mm_madd_epi16(high, high));
+        }
+        
+        // Lane harus unsigned, lihat MADD_FLUSH_ITERATIONS
+        alignas(16) unsigned int lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), accumulator);
+        total += static_cast<unsigned long long>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+    
+    return total + squaredDeviationScalar(row + i, count - i, avg);
+}
+
+__attribute__((target("sse2")))
+static unsigned long long absoluteDeviationSse2(const BYTE* row, int count, BYTE avg) {
+    const __m128i average = _mm_set1_epi8(static_cast<char>(avg));
+    __m128i accumulator = _mm_setzero_si128();
+    int i = 0;
+    
+    // _mm_sad_epu8 langsung menjumlahkan |p - avg| ke dua lane 64 bit
+    for (; i + 16 <= count; i += 16) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        accumulator = _mm_add_epi64(accumulator, _mm_sad_epu8(pixels, average));
+    }
+    
+    alignas(16) unsigned long long lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), accumulator);
+    
+    return lanes[0] + lanes[1] + absoluteDeviationScalar(row + i, count - i, avg);
+}
+
+__attribute__((target("sse2")))
+static void minMaxSse2(const BYTE* row, int count, BYTE& minValue, BYTE& maxValue) {
+    __m128i minimum = _mm_set1_epi8(static_cast<char>(minValue));
+    __m128i maximum = _mm_set1_epi8(static_cast<char>(maxValue));
+    int i = 0;
+    
+    for (; i + 16 <= count; i += 16) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        minimum = _mm_min_epu8(minimum, pixels);
+        maximum = _mm_max_epu8(maximum, pixels);
+    }
+    
+    alignas(16) BYTE minLanes[16], maxLanes[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(minLanes), minimum);
+    _mm_store_si128(reinterpret_cast<__m128i*>(maxLanes), maximum);
+    
+    for (int lane = 0; lane < 16; lane++) {
+        minValue = std::min(minValue, minLanes[lane]);
+        maxValue = std::max(maxValue, maxLanes[lane]);
+    }
+    minMaxScalar(row + i, count - i, minValue, maxValue);
+}
+
+// ===== Versi AVX2 (32 pixel per iterasi) =====
+
+__attribute__((target("avx2")))
+static unsigned long long squaredDeviationAvx2(const BYTE* row, int count, BYTE avg) {
+    const __m256i average = _mm256_set1_epi16(avg);
+    unsigned long long total = 0;
+    int i = 0;
+    
+    while (i + 32 <= count) {
+        __m256i accumulator = _mm256_setzero_si256();
+        
+        for (int iteration = 0; iteration < MADD_FLUSH_ITERATIONS && i + 32 <= count; iteration++, i += 32) {
+            __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i + 16));
+            
+            __m256i low = _mm256_sub_epi16(_mm256_cvtepu8_epi16(first), average);
+            __m256i high = _mm256_sub_epi16(_mm256_cvtepu8_epi16(second), average);
+            
+            accumulator = _mm256_add_epi32(accumulator, _mm256_madd_epi16(low, low));
+            accumulator = _mm256_add_epi32(accumulator, _mm256_madd_epi16(high, high));
+        }
+        
+        // Batas per lane sama dengan versi SSE2 (4 * 255^2 per iterasi), lane harus unsigned
+        alignas(32) unsigned int lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), accumulator);
+        for (int lane = 0; lane < 8; lane++) {
+            total += lanes[lane];
+        }
+    }
+    
+    return total + squaredDeviationSse2(row + i, count - i, avg);
+}
+
+__attribute__((target("avx2")))
+static unsigned long long absoluteDeviationAvx2(const BYTE* row, int count, BYTE avg) {
+    const __m256i average = _mm256_set1_epi8(static_cast<char>(avg));
+    __m256i accumulator = _mm256_setzero_si256();
+    int i = 0;
+    
+    for (; i + 32 <= count; i += 32) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        accumulator = _mm256_add_epi64(accumulator, _mm256_sad_epu8(pixels, average));
+    }
+    
+    alignas(32) unsigned long long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), accumulator);
+    
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + absoluteDeviationSse2(row + i, count - i, avg);
+}
+
+__attribute__((target("avx2")))
+static void minMaxAvx2(const BYTE* row, int count, BYTE& minValue, BYTE& maxValue) {
+    __m256i minimum = _mm256_set1_epi8(static_cast<char>(minValue));
+    __m256i maximum = _mm256_set1_epi8(static_cast<char>(maxValue));
+    int i = 0;
+    
+    for (; i + 32 <= count; i += 32) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        minimum = _mm256_min_epu8(minimum, pixels);
+        maximum = _mm256_max_epu8(maximum, pixels);
+    }
+    
+    alignas(32) BYTE minLanes[32], maxLanes[32];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(minLanes), minimum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(maxLanes), maximum);
+    
+    for (int lane = 0; lane < 32; lane++) {
+        minValue = std::min(minValue, minLanes[lane]);
+        maxValue = std::max(maxValue, maxLanes[lane]);
+    }
+    minMaxSse2(row + i, count - i, minValue, maxValue);
+}
+
+#endif
+
+// ===== Dispatch =====
+
+static const RowKernels scalarKernels = {squaredDeviationScalar, absoluteDeviationScalar, minMaxScalar};
+#ifdef QUADTREE_HAS_X86_SIMD
+static const RowKernels sse2Kernels = {squaredDeviationSse2, absoluteDeviationSse2, minMaxSse2};
+static const RowKernels avx2Kernels = {squaredDeviationAvx2, absoluteDeviationAvx2, minMaxAvx2};
+#endif
+
+// Fungsi untuk mendeteksi tingkat SIMD tertinggi yang didukung CPU
+SimdLevel detectSimdLevel() {
+#ifdef QUADTREE_HAS_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+#endif
+    return SIMD_SCALAR;
+}
+
+static SimdLevel& activeSimdLevel() {
+    static SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+SimdLevel getSimdLevel() {
+    return activeSimdLevel();
+}
+
+// Fungsi untuk memaksa tingkat SIMD tertentu (misalnya skalar sebagai acuan);
+// tingkat yang tidak didukung CPU diturunkan ke yang tertinggi yang didukung
+void setSimdLevel(SimdLevel level) {
+    activeSimdLevel() = std::min(level, detectSimdLevel());
+}
+
+const char* getSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SIMD_AVX2: return "AVX2";
+        case SIMD_SSE2: return "SSE2";
+        default: return "Scalar";
+    }
+}
+
+const RowKernels& getRowKernels() {
+    switch (activeSimdLevel()) {
+#ifdef QUADTREE_HAS_X86_SIMD
+        case SIMD_AVX2: return avx2Kernels;
+        case SIMD_SSE2: return sse2Kernels;
+#endif
+        default: return scalarKernels;
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include "FreeImage.h"
+
+// Tingkat instruksi SIMD yang dipakai kernel baris, dipilih saat runtime
+enum SimdLevel {
+    SIMD_SCALAR = 0,
+    SIMD_SSE2 = 1,
+    SIMD_AVX2 = 2
+};
+
+// Kernel untuk satu baris pixel (satu channel) yang bersebelahan di memori.
+// Semua akumulasi memakai integer sehingga hasil SIMD sama persis dengan versi skalar.
+struct RowKernels {
+    // Sum((p - avg)^2)
+    unsigned long long (*squaredDeviation)(const BYTE* row, int count, BYTE avg);
+    // Sum(|p - avg|)
+    unsigned long long (*absoluteDeviation)(const BYTE* row, int count, BYTE avg);
+    // Memperbarui nilai minimum dan maksimum
+    void (*minMax)(const BYTE* row, int count, BYTE& minValue, BYTE& maxValue);
+};
+
+// Fungsi untuk memilih dan membaca tingkat SIMD
+SimdLevel detectSimdLevel();
+SimdLevel getSimdLevel();
+void setSimdLevel(SimdLevel level);
+const char* getSimdLevelName(SimdLevel level);
+
+// Kernel sesuai tingkat SIMD yang aktif (default: terbaik yang didukung CPU)
+const RowKernels& getRowKernels();
+
+#endif
@@ -0,0 +1,139 @@
+#include "thread_pool.h"
+
+// Worker milik pool mana yang sedang berjalan di thread ini (-1 untuk thread luar)
+static thread_local ThreadPool* currentPool = nullptr;
+static thread_local int currentWorker = -1;
+
+// threadCount termasuk thread pemanggil, yang ikut bekerja saat TaskGroup::wait()
+ThreadPool::ThreadPool(int threadCount) : pendingTasks(0), stopping(false) {
+    int workerCount = threadCount > 1 ? threadCount - 1 : 0;
+    
+    // Satu deque per worker ditambah satu antrian global untuk task dari luar pool
+    for (int i = 0; i <= workerCount; i++) {
+        queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+    
+    for (int i = 0; i < workerCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task, const TaskGroup* group) {
+    int index = (currentPool == this && currentWorker >= 0) ? currentWorker : static_cast<int>(workers.size());
+    
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(PendingTask{std::move(task), group});
+        pendingTasks++;
+    }
+    
+    // Kunci sleepMutex sesaat agar notifikasi tidak hilang di antara cek predikat dan wait
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeUp.notify_one();
+}
+
+// Fungsi untuk mengambil task terbaru (newest) atau tertua dari satu deque. Jika group
+// diberikan, hanya task milik grup itu yang diambil.
+bool ThreadPool::takeTask(WorkerQueue& queue, bool newest, const TaskGroup* group, std::function<void()>& task) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    int count = static_cast<int>(queue.tasks.size());
+    
+    for (int k = 0; k < count; k++) {
+        int position = newest ? count - 1 - k : k;
+        if (group && queue.tasks[position].group != group) continue;
+        
+        task = std::move(queue.tasks[position].run);
+        queue.tasks.erase(queue.tasks.begin() + position);
+        pendingTasks--;
+        return true;
+    }
+    
+    return false;
+}
+
+bool ThreadPool::popTask(std::function<void()>& task, const TaskGroup* group) {
+    int queueCount = static_cast<int>(queues.size());
+    int own = (currentPool == this && currentWorker >= 0) ? currentWorker : -1;
+    
+    // 1. Task terbaru dari deque sendiri (lokalitas cache paling baik)
+    if (own >= 0 && takeTask(*queues[own], true, group, task)) {
+        return true;
+    }
+    
+    // 2. Curi task tertua dari antrian global dan deque worker lain
+    int start = own >= 0 ? own + 1 : 0;
+    for (int k = 0; k < queueCount; k++) {
+        int victim = (start + k) % queueCount;
+        if (victim == own) continue;
+        
+        if (takeTask(*queues[victim], false, group, task)) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+bool ThreadPool::runPendingTask(const TaskGroup* group) {
+    std::function<void()> task;
+    if (!popTask(task, group)) return false;
+    
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(int index) {
+    currentPool = this;
+    currentWorker = index;
+    
+    while (true) {
+        std::function<void()> task;
+        if (popTask(task, nullptr)) {
+            task();
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this] { return stopping || pendingTasks > 0; });
+        
+        if (stopping && pendingTasks == 0) return;
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    remaining++;
+    pool.submit([this, task]() {
+        task();
+        
+        // Penghitung diturunkan di bawah doneMutex: wait() baru bisa kembali (dan grup dihapus)
+        // setelah thread ini melepas kunci
+        std::lock_guard<std::mutex> lock(doneMutex);
+        if (--remaining == 0) {
+            done.notify_all();
+        }
+    }, this);
+}
+
+void TaskGroup::wait() {
+    // Kerjakan sendiri task grup ini yang masih antri, lalu tunggu task yang diambil thread lain
+    while (remaining > 0) {
+        if (!pool.runPendingTask(this)) break;
+    }
+    
+    std::unique_lock<std::mutex> lock(doneMutex);
+    done.wait(lock, [this] { return remaining == 0; });
+}
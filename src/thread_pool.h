@@ -0,0 +1,80 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskGroup;
+
+// Thread pool dengan work stealing: setiap worker punya deque sendiri,
+// mengambil task terbaru dari belakang (LIFO) dan mencuri task tertua
+// dari depan deque worker lain (FIFO) ketika deque-nya kosong.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    // Masukkan task ke deque worker pemanggil (atau antrian global jika dari luar pool).
+    // group menandai TaskGroup pemilik task, nullptr untuk task lepas.
+    void submit(std::function<void()> task, const TaskGroup* group = nullptr);
+    
+    // Jalankan satu task yang tersedia, dipakai oleh thread yang sedang menunggu. Jika group
+    // diberikan, hanya task milik grup itu yang diambil.
+    bool runPendingTask(const TaskGroup* group = nullptr);
+    
+    // Jumlah thread yang bekerja, termasuk thread pemanggil
+    int threadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+private:
+    struct PendingTask {
+        std::function<void()> run;
+        const TaskGroup* group;
+    };
+    
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<PendingTask> tasks;
+    };
+    
+    bool takeTask(WorkerQueue& queue, bool newest, const TaskGroup* group, std::function<void()>& task);
+    bool popTask(std::function<void()>& task, const TaskGroup* group);
+    void workerLoop(int index);
+    
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;  // queues[workers.size()] = antrian global
+    
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<int> pendingTasks;
+    std::atomic<bool> stopping;
+};
+
+// Sekumpulan task fork-join. wait() hanya ikut mengerjakan task milik grup ini yang belum
+// diambil thread lain, lalu tidur sampai semua task grup selesai. Task grup lain tidak pernah
+// dijalankan di stack thread yang menunggu, sehingga kedalaman stack rekursi fork-join tetap
+// sebatas kedalaman rekursinya sendiri.
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool) : pool(pool), remaining(0) {}
+    ~TaskGroup() { wait(); }
+    
+    void run(std::function<void()> task);
+    void wait();
+
+private:
+    ThreadPool& pool;
+    std::atomic<int> remaining;
+    std::mutex doneMutex;
+    std::condition_variable done;
+};
+
+#endif
@@ -0,0 +1,342 @@
+// off_t 64 bit untuk fseeko/ftello, juga di Linux 32 bit; harus didefinisikan sebelum header sistem
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "tiled.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+// Posisi file 64 bit agar gambar lebih dari 2 GB bisa dibaca
+#ifdef _WIN32
+#define seekFile _fseeki64
+#define tellFile _ftelli64
+#else
+#define seekFile fseeko
+#define tellFile ftello
+#endif
+
+// ===== Pembacaan PPM/PGM biner per baris =====
+
+// File PPM (P6) atau PGM (P5) biner yang dibuka untuk dibaca sebagian. Baris file disimpan
+// dari atas ke bawah, kebalikan dari urutan baris ImageView.
+struct PPMReader {
+    FILE* file;
+    int width, height;
+    int channels;
+    long long dataOffset;
+};
+
+// Fungsi untuk membaca satu bilangan header, melewati spasi dan komentar (#)
+static bool readHeaderNumber(FILE* file, int& value) {
+    int c = fgetc(file);
+    while (c != EOF && (isspace(c) || c == '#')) {
+        if (c == '#') {
+            while (c != EOF && c != '\n') c = fgetc(file);
+        }
+        c = fgetc(file);
+    }
+    
+    long long number = 0;
+    bool hasDigit = false;
+    while (c != EOF && isdigit(c)) {
+        number = number * 10 + (c - '0');
+        if (number > 0x7FFFFFFF) return false;
+        hasDigit = true;
+        c = fgetc(file);
+    }
+    
+    // Satu karakter spasi setelah bilangan terakhir header sudah terbaca di sini
+    value = static_cast<int>(number);
+    return hasDigit && (c == EOF || isspace(c));
+}
+
+static bool openPPMReader(const std::string& path, PPMReader& reader) {
+    reader.file = fopen(path.c_str(), "rb");
+    if (!reader.file) return false;
+    
+    char magic[2];
+    int maxValue = 0;
+    if (fread(magic, 1, 2, reader.file) != 2 || magic[0] != 'P' || (magic[1] != '6' && magic[1] != '5') ||
+        !readHeaderNumber(reader.file, reader.width) || !readHeaderNumber(reader.file, reader.height) ||
+        !readHeaderNumber(reader.file, maxValue) || reader.width <= 0 || reader.height <= 0 ||
+        maxValue <= 0 || maxValue > 255) {
+        fclose(reader.file);
+        reader.file = nullptr;
+        return false;
+    }
+    
+    reader.channels = magic[1] == '6' ? 3 : 1;
+    reader.dataOffset = tellFile(reader.file);
+    return true;
+}
+
+// Fungsi untuk membaca baris ImageView [firstRow, firstRow + rowCount) ke band (planar).
+// Baris ImageView ke-j adalah baris file ke-(height - 1 - j), jadi satu pita ImageView adalah
+// blok baris file yang bersebelahan dan cukup dibaca dengan satu seek.
+static bool readPPMBand(PPMReader& reader, int firstRow, int rowCount, ImageView& band, std::vector<BYTE>& buffer) {
+    size_t rowBytes = static_cast<size_t>(reader.width) * reader.channels;
+    int firstFileRow = reader.height - firstRow - rowCount;
+    
+    buffer.resize(rowBytes * rowCount);
+    long long offset = reader.dataOffset + static_cast<long long>(firstFileRow) * rowBytes;
+    if (seekFile(reader.file, offset, SEEK_SET) != 0 ||
+        fread(buffer.data(), 1, buffer.size(), reader.file) != buffer.size()) {
+        return false;
+    }
+    
+    for (int k = 0; k < rowCount; k++) {
+        const BYTE* source = buffer.data() + k * rowBytes;
+        int j = rowCount - 1 - k;
+        BYTE* red = band.row(0, j);
+        BYTE* green = band.row(1, j);
+        BYTE* blue = band.row(2, j);
+        
+        // PGM dibaca ke pita satu channel
+        if (reader.channels == 1) {
+            memcpy(red, source, reader.width);
+            continue;
+        }
+        
+        for (int i = 0; i < reader.width; i++) {
+            red[i] = source[i * 3];
+            green[i] = source[i * 3 + 1];
+            blue[i] = source[i * 3 + 2];
+        }
+    }
+    return true;
+}
+
+// ===== Sumber pixel =====
+
+// PPM/PGM dibaca langsung per pita. Format lain dimuat utuh lewat FreeImage (tidak hemat
+// memori untuk input, tetapi integral image, pohon dan output tetap per tile/pita).
+struct TileSource {
+    bool streamed;
+    PPMReader ppm;
+    ImageView image;
+    std::vector<BYTE> buffer;
+};
+
+static bool openTileSource(const std::string& path, TileSource& source, std::ostream& log) {
+    source.streamed = openPPMReader(path, source.ppm);
+    if (source.streamed) {
+        source.image.width = source.ppm.width;
+        source.image.height = source.ppm.height;
+        source.image.channels = source.ppm.channels;
+        return true;
+    }
+    
+    FREE_IMAGE_FORMAT format = FreeImage_GetFileType(path.c_str());
+    if (format == FIF_UNKNOWN) {
+        format = FreeImage_GetFIFFromFilename(path.c_str());
+    }
+    if (format == FIF_UNKNOWN || !FreeImage_FIFSupportsReading(format)) {
+        log << "Format gambar input tidak didukung atau file tidak ditemukan!" << std::endl;
+        return false;
+    }
+    
+    FIBITMAP* originalImage = FreeImage_Load(format, path.c_str());
+    if (!originalImage) {
+        log << "Gagal memuat gambar input!" << std::endl;
+        return false;
+    }
+    
+    log << "Input bukan PPM/PGM biner, gambar dimuat utuh ke memori" << std::endl;
+    source.image = createImageView(originalImage);
+    FreeImage_Unload(originalImage);
+    return true;
+}
+
+static bool readSourceBand(TileSource& source, int firstRow, int rowCount, ImageView& band) {
+    if (source.streamed) {
+        return readPPMBand(source.ppm, firstRow, rowCount, band, source.buffer);
+    }
+    
+    size_t offset = static_cast<size_t>(firstRow) * source.image.width;
+    size_t count = static_cast<size_t>(rowCount) * source.image.width;
+    for (int c = 0; c < source.image.channels; c++) {
+        std::copy(source.image.planes[c].begin() + offset, source.image.planes[c].begin() + offset + count,
+                  band.planes[c].begin());
+    }
+    return true;
+}
+
+static void closeTileSource(TileSource& source) {
+    if (source.streamed && source.ppm.file) {
+        fclose(source.ppm.file);
+        source.ppm.file = nullptr;
+    }
+}
+
+// Fungsi untuk menulis pita output ke PPM, baris teratas gambar lebih dulu
+static bool writePPMBand(FILE* file, const ImageView& band, std::vector<BYTE>& line) {
+    line.resize(static_cast<size_t>(band.width) * 3);
+    
+    for (int j = band.height - 1; j >= 0; j--) {
+        const BYTE* red = band.row(0, j);
+        const BYTE* green = band.row(1, j);
+        const BYTE* blue = band.row(2, j);
+        for (int i = 0; i < band.width; i++) {
+            line[i * 3] = red[i];
+            line[i * 3 + 1] = green[i];
+            line[i * 3 + 2] = blue[i];
+        }
+        if (fwrite(line.data(), 1, line.size(), file) != line.size()) return false;
+    }
+    return true;
+}
+
+// ===== Pembagian tile =====
+
+void splitQuadTreeAxis(int length, int depth, std::vector<int>& offsets) {
+    offsets.assign(1, 0);
+    offsets.push_back(length);
+    
+    // Setiap tingkat membagi setiap ruas [a, b) menjadi [a, a + n/2) dan [a + n/2, b),
+    // sama seperti splitQuadTreeNode
+    for (int level = 0; level < depth; level++) {
+        std::vector<int> next;
+        next.reserve(offsets.size() * 2);
+        for (size_t i = 0; i + 1 < offsets.size(); i++) {
+            next.push_back(offsets[i]);
+            next.push_back(offsets[i] + (offsets[i + 1] - offsets[i]) / 2);
+        }
+        next.push_back(length);
+        offsets.swap(next);
+    }
+}
+
+int chooseTileDepth(int width, int height, int minBlockSize, int tileSize) {
+    int depth = 0;
+    
+    // Sisi node pada kedalaman d adalah floor atau ceil dari sisi gambar / 2^d. Pembagian
+    // hanya dilanjutkan jika node terkecil pada kedalaman ini masih boleh dibagi.
+    long long largestWidth = width, largestHeight = height;
+    long long smallestWidth = width, smallestHeight = height;
+    while ((largestWidth > tileSize || largestHeight > tileSize) &&
+           canSplitQuadTreeBlock(static_cast<int>(smallestWidth), static_cast<int>(smallestHeight), minBlockSize)) {
+        largestWidth = (largestWidth + 1) / 2;
+        largestHeight = (largestHeight + 1) / 2;
+        smallestWidth /= 2;
+        smallestHeight /= 2;
+        depth++;
+    }
+    return depth;
+}
+
+// ===== Mode tile =====
+
+// Fungsi untuk menyalin kolom [x, x + width) sebuah pita menjadi ImageView tersendiri
+static ImageView extractTile(const ImageView& band, int x, int width) {
+    ImageView tile = createImageView(width, band.height, band.channels);
+    for (int c = 0; c < band.channels; c++) {
+        for (int j = 0; j < band.height; j++) {
+            memcpy(tile.row(c, j), band.row(c, j) + x, width);
+        }
+    }
+    return tile;
+}
+
+bool compressTiled(const std::string& inputPath, const std::string& outputPath,
+                   const TiledOptions& options, TiledResult& result, std::ostream& log) {
+    TileSource source;
+    if (!openTileSource(inputPath, source, log)) return false;
+    
+    int width = source.image.width;
+    int height = source.image.height;
+    result.width = width;
+    result.height = height;
+    result.streamedInput = source.streamed;
+    
+    int depth = chooseTileDepth(width, height, options.minBlockSize, options.tileSize);
+    std::vector<int> columns, rows;
+    splitQuadTreeAxis(width, depth, columns);
+    splitQuadTreeAxis(height, depth, rows);
+    
+    result.tileDepth = depth;
+    result.tileCount = static_cast<int>((columns.size() - 1) * (rows.size() - 1));
+    result.maxDepth = depth;
+    
+    // Node di atas kedalaman tile: 1 + 4 + ... + 4^(depth - 1)
+    result.nodeCount = 0;
+    for (int level = 0; level < depth; level++) {
+        result.nodeCount += 1LL << (2 * level);
+    }
+    
+    log << "Membagi gambar " << width << "x" << height << " menjadi " << result.tileCount
+        << " tile (kedalaman " << depth << ")..." << std::endl;
+    
+    FILE* output = fopen(outputPath.c_str(), "wb");
+    if (!output) {
+        log << "Gagal membuka file output!" << std::endl;
+        closeTileSource(source);
+        return false;
+    }
+    fprintf(output, "P6\n%d %d\n255\n", width, height);
+    
+    ThreadPool pool(std::max(1, options.threadCount));
+    std::atomic<long long> nodeCount(result.nodeCount);
+    std::atomic<int> maxDepth(depth);
+    std::vector<BYTE> line;
+    bool success = true;
+    
+    // Pita diproses dari atas gambar (baris ImageView terbesar) agar PPM ditulis berurutan
+    for (int row = static_cast<int>(rows.size()) - 2; row >= 0 && success; row--) {
+        int y = rows[row];
+        int bandHeight = rows[row + 1] - y;
+        
+        ImageView band = createImageView(width, bandHeight, source.image.channels);
+        if (!readSourceBand(source, y, bandHeight, band)) {
+            log << "Gagal membaca baris " << y << " dari gambar input!" << std::endl;
+            success = false;
+            break;
+        }
+        
+        ImageView outputBand = createImageView(width, bandHeight);
+        {
+            TaskGroup group(pool);
+            for (size_t column = 0; column + 1 < columns.size(); column++) {
+                group.run([&, column] {
+                    int x = columns[column];
+                    int tileWidth = columns[column + 1] - x;
+                    
+                    ImageView tile = extractTile(band, x, tileWidth);
+                    IntegralImage integral = buildIntegralImage(tile);
+                    QuadTree tree = buildQuadTree(tile, integral, 0, 0, tileWidth, bandHeight,
+                                                  options.minBlockSize, options.threshold, options.method);
+                    
+                    // Geser node ke posisi tile di dalam pita lalu gambar langsung ke pita output;
+                    // setiap tile menulis kolom yang berbeda
+                    for (QuadTreeNode& node : tree.nodes) {
+                        node.x += x;
+                    }
+                    drawQuadTree(outputBand, tree);
+                    
+                    nodeCount += static_cast<long long>(tree.nodes.size());
+                    int tileDepth = depth + getQuadTreeDepth(tree);
+                    int current = maxDepth.load();
+                    while (tileDepth > current && !maxDepth.compare_exchange_weak(current, tileDepth)) {
+                    }
+                });
+            }
+            group.wait();
+        }
+        
+        if (!writePPMBand(output, outputBand, line)) {
+            log << "Gagal menulis file output!" << std::endl;
+            success = false;
+        }
+    }
+    
+    success = (fclose(output) == 0) && success;
+    closeTileSource(source);
+    
+    result.nodeCount = nodeCount;
+    result.maxDepth = maxDepth;
+    return success;
+}
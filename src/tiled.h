@@ -0,0 +1,46 @@
+#ifndef TILED_H
+#define TILED_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "quadtree.h"
+
+// Mode tile untuk gambar yang lebih besar dari memori. Gambar dibagi menjadi node Quadtree
+// pada kedalaman tileDepth (tile); node di atas kedalaman itu selalu dibagi, lalu subtree
+// setiap tile dibangun dan digambar sendiri-sendiri. Hasilnya sama dengan mode biasa selama
+// pohon penuh memang membagi semua node di atas kedalaman tile (umumnya benar untuk gambar
+// besar, tetapi sering tidak untuk Entropy). Input PPM/PGM biner dibaca per pita baris dan
+// output PPM ditulis per pita. Memori kerja: pita input (3 B/pixel), buffer baca baris file,
+// pita output (3 B/pixel), lalu untuk setiap tile yang sedang diproses salinan tile dan integral
+// image (sekitar 48 B/pixel, enam tabel 64 bit) ditambah pohonnya.
+struct TiledOptions {
+    int method;
+    double threshold;
+    int minBlockSize;
+    int tileSize;       // Sisi maksimum tile dalam pixel
+    int threadCount;    // Tile dalam satu pita diproses paralel, satu thread per tile
+};
+
+struct TiledResult {
+    int width, height;
+    int tileDepth;
+    int tileCount;
+    long long nodeCount;
+    int maxDepth;
+    bool streamedInput;     // false jika input dimuat utuh lewat FreeImage
+};
+
+// Fungsi untuk menghitung batas node pada satu sumbu setelah dibagi depth kali dengan aturan
+// splitQuadTreeNode. offsets berisi 2^depth + 1 nilai, dimulai 0 dan diakhiri length.
+void splitQuadTreeAxis(int length, int depth, std::vector<int>& offsets);
+
+// Fungsi untuk memilih kedalaman tile terkecil yang sisi tilenya tidak lebih dari tileSize,
+// dibatasi agar semua node di atasnya masih boleh dibagi menurut minBlockSize
+int chooseTileDepth(int width, int height, int minBlockSize, int tileSize);
+
+// Fungsi untuk mengompresi gambar dalam mode tile dan menulis hasilnya sebagai PPM
+bool compressTiled(const std::string& inputPath, const std::string& outputPath,
+                   const TiledOptions& options, TiledResult& result, std::ostream& log);
+
+#endif
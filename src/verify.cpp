@@ -0,0 +1,417 @@
+#include "verify.h"
+#include "qtc_format.h"
+#include "simd_kernels.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+// Threshold yang diuji per metode (indeks 1-5): satu halus dan satu kasar
+static const double VERIFY_THRESHOLDS[6][2] = {{0, 0}, {50, 300}, {5, 20}, {20, 60}, {3, 6}, {50, 500}};
+static const int VERIFY_MIN_BLOCK_SIZES[2] = {1, 4};
+
+static const unsigned long long FNV_OFFSET = 1469598103934665603ULL;
+static const unsigned long long FNV_PRIME = 1099511628211ULL;
+
+static void hashValue(unsigned long long& hash, unsigned int value) {
+    for (int i = 0; i < 4; i++) {
+        hash ^= (value >> (8 * i)) & 0xFF;
+        hash *= FNV_PRIME;
+    }
+}
+
+// Daun dikunjungi dalam pre-order (kiri atas, kanan atas, kiri bawah, kanan bawah) sehingga
+// hash tidak bergantung pada urutan node di dalam array
+unsigned long long hashQuadTreeLeaves(const QuadTree& tree) {
+    unsigned long long hash = FNV_OFFSET;
+    if (tree.nodes.empty()) return hash;
+    
+    std::vector<int> stack(1, 0);
+    while (!stack.empty()) {
+        const QuadTreeNode& node = tree.nodes[stack.back()];
+        stack.pop_back();
+        
+        if (!node.isLeaf()) {
+            for (int quadrant = 3; quadrant >= 0; quadrant--) {
+                stack.push_back(node.firstChild + quadrant);
+            }
+            continue;
+        }
+        
+        hashValue(hash, node.x);
+        hashValue(hash, node.y);
+        hashValue(hash, node.width);
+        hashValue(hash, node.height);
+        hashValue(hash, node.avgColor.rgbRed | (node.avgColor.rgbGreen << 8) | (node.avgColor.rgbBlue << 16));
+    }
+    return hash;
+}
+
+// Pixel di-hash dalam urutan R, G, B per pixel agar bisa dibandingkan dengan buffer renderQTC
+static unsigned long long hashInterleavedRows(const BYTE* pixels, int width, int height, size_t pitch) {
+    unsigned long long hash = FNV_OFFSET;
+    for (int j = 0; j < height; j++) {
+        const BYTE* row = pixels + j * pitch;
+        for (int i = 0; i < width * 3; i++) {
+            hash ^= row[i];
+            hash *= FNV_PRIME;
+        }
+    }
+    return hash;
+}
+
+unsigned long long hashImageView(const ImageView& image) {
+    std::vector<BYTE> row(static_cast<size_t>(image.width) * 3);
+    unsigned long long hash = FNV_OFFSET;
+    
+    for (int j = 0; j < image.height; j++) {
+        for (int c = 0; c < 3; c++) {
+            const BYTE* plane = image.row(c, j);
+            for (int i = 0; i < image.width; i++) {
+                row[i * 3 + c] = plane[i];
+            }
+        }
+        for (BYTE value : row) {
+            hash ^= value;
+            hash *= FNV_PRIME;
+        }
+    }
+    return hash;
+}
+
+// Fungsi untuk membandingkan satu jalur dengan referensi dan mencatat perbedaannya
+static bool checkPath(const char* path, const VerifyCase& reference, const QuadTree& tree,
+                      std::ostream& log, int& failures) {
+    unsigned long long leafHash = hashQuadTreeLeaves(tree);
+    if (static_cast<int>(tree.nodes.size()) == reference.nodeCount && leafHash == reference.leafHash) {
+        return true;
+    }
+    
+    log << "  BEDA " << path << ": " << tree.nodes.size() << " simpul (referensi "
+        << reference.nodeCount << ")" << std::endl;
+    failures++;
+    return false;
+}
+
+static bool checkPixels(const char* path, const VerifyCase& reference, unsigned long long pixelHash,
+                        std::ostream& log, int& failures) {
+    if (pixelHash == reference.pixelHash) return true;
+    
+    log << "  BEDA " << path << ": pixel output berbeda dari drawQuadTree referensi" << std::endl;
+    failures++;
+    return false;
+}
+
+// Fungsi untuk me-render buffer .qtc dan menghitung hash pixelnya (0 jika gagal)
+static unsigned long long hashRenderedQTC(const std::vector<BYTE>& buffer, int width, int height) {
+    std::vector<BYTE> pixels(static_cast<size_t>(width) * height * 3);
+    if (!renderQTC(buffer.data(), buffer.size(), pixels.data(), width * 3)) return 0;
+    return hashInterleavedRows(pixels.data(), width, height, static_cast<size_t>(width) * 3);
+}
+
+// Fungsi error blok untuk pembangunan dari atas ke bawah di bawah ini
+typedef double (*BlockErrorFunction)(const ImageView& image, int x, int y, int width, int height,
+                                     RGBQUAD avgColor, int method);
+
+// Referensi: statistik blok dikumpulkan dengan satu scan pixel skalar (tanpa kernel SIMD)
+static double referenceBlockError(const ImageView& image, int x, int y, int width, int height,
+                                  RGBQUAD, int method) {
+    return calculateError(image, x, y, width, height, method);
+}
+
+// Fungsi error per pixel yang memakai kernel baris SIMD aktif, tanpa integral image
+static double pixelBlockError(const ImageView& image, int x, int y, int width, int height,
+                              RGBQUAD avgColor, int method) {
+    switch (method) {
+        case 2: return calculateMAD(image, x, y, width, height, avgColor);
+        case 3: return calculateMaxDifference(image, x, y, width, height);
+        case 4: return calculateEntropy(image, x, y, width, height);
+        case 5: return calculateSSIM(image, x, y, width, height, avgColor);
+        default: return calculateVariance(image, x, y, width, height, avgColor);
+    }
+}
+
+// Rekursi pembangunan dari atas ke bawah yang hanya membaca pixel: warna rata-rata per pixel,
+// lalu blok dibagi jika masih boleh dibagi dan errornya melebihi threshold
+static void buildTopDownSubtree(QuadTree& tree, int index, const ImageView& image, int minBlockSize,
+                                double threshold, int method, BlockErrorFunction blockError) {
+    QuadTreeNode& node = tree.nodes[index];
+    node.avgColor = calculateAverageColor(image, node.x, node.y, node.width, node.height);
+    
+    if (!canSplitQuadTreeBlock(node.width, node.height, minBlockSize) ||
+        blockError(image, node.x, node.y, node.width, node.height, node.avgColor, method) <= threshold) {
+        return;
+    }
+    
+    int first = splitQuadTreeNode(tree, index);
+    for (int quadrant = 0; quadrant < 4; quadrant++) {
+        buildTopDownSubtree(tree, first + quadrant, image, minBlockSize, threshold, method, blockError);
+    }
+}
+
+static QuadTree buildTopDownTree(const ImageView& image, int minBlockSize, double threshold, int method,
+                                 BlockErrorFunction blockError) {
+    QuadTree tree;
+    addQuadTreeNode(tree, 0, 0, image.width, image.height);
+    buildTopDownSubtree(tree, 0, image, minBlockSize, threshold, method, blockError);
+    return tree;
+}
+
+// Ukuran potongan writeQTCStream dan jumlah potongan awal yang di-decode readQTCStream
+static const size_t VERIFY_STREAM_CHUNK_BYTES = 257;
+static const size_t VERIFY_STREAM_PREFIXES = 16;
+
+// Fungsi untuk memverifikasi stream progresif: output writeQTCStream per potongan harus sama
+// dengan encodeQTCProgressive, dan readQTCStream yang dilanjutkan pada potongan awal yang makin
+// panjang (termasuk header yang belum lengkap) harus berakhir dengan pohon yang sama
+static int verifyQTCStream(const QuadTree& tree, int minBlockSize, const VerifyCase& reference, std::ostream& log) {
+    int failures = 0;
+    
+    std::vector<BYTE> expected;
+    if (!encodeQTCProgressive(tree, minBlockSize, expected)) {
+        log << "  BEDA qtc-stream: gagal encode" << std::endl;
+        return 1;
+    }
+    
+    std::vector<BYTE> chunked;
+    QTCStreamEncoder encoder;
+    bool started = startQTCStream(tree, minBlockSize, encoder, chunked);
+    while (started) {
+        if (writeQTCStream(encoder, chunked, VERIFY_STREAM_CHUNK_BYTES)) break;
+    }
+    if (!started || chunked != expected) {
+        log << "  BEDA qtc-stream: output writeQTCStream per " << VERIFY_STREAM_CHUNK_BYTES
+            << " byte berbeda dari encodeQTCProgressive" << std::endl;
+        failures++;
+    }
+    
+    // Potongan awal: 1 byte, header tanpa tabel kode, header dengan tabel kode kurang 1 byte,
+    // lalu bertambah rata hingga seluruh stream. Stream baru boleh selesai pada potongan terakhir.
+    std::vector<size_t> prefixes = {1, QTC_HEADER_SIZE, QTC_HEADER_SIZE + QTC_CODE_TABLE_SIZE - 1};
+    size_t step = expected.size() / VERIFY_STREAM_PREFIXES + 1;
+    for (size_t size = QTC_HEADER_SIZE + QTC_CODE_TABLE_SIZE; size < expected.size(); size += step) {
+        prefixes.push_back(size);
+    }
+    prefixes.push_back(expected.size());
+    
+    QTCStreamDecoder decoder;
+    resetQTCStreamDecoder(decoder);
+    QTCStreamStatus status = QTC_STREAM_ERROR;
+    for (size_t size : prefixes) {
+        status = readQTCStream(decoder, expected.data(), size);
+        if (status != QTC_STREAM_NEED_MORE) {
+            if (size < expected.size()) status = QTC_STREAM_ERROR;
+            break;
+        }
+    }
+    
+    if (status != QTC_STREAM_COMPLETE) {
+        log << "  BEDA qtc-stream+prefix: readQTCStream gagal pada potongan awal yang bertambah" << std::endl;
+        return failures + 1;
+    }
+    
+    checkPath("qtc-stream+prefix", reference, decoder.tree, log, failures);
+    return failures;
+}
+
+static int verifyCase(const ImageView& image, const ImageView& referenceImage, const IntegralImage& integral,
+                      int threadCount, VerifyCase& reference, std::ostream& log) {
+    int method = reference.method;
+    double threshold = reference.threshold;
+    int minBlockSize = reference.minBlockSize;
+    int width = image.width;
+    int height = image.height;
+    int failures = 0;
+    
+    // Referensi: rekursi dari atas ke bawah dengan statistik blok dari scan pixel skalar,
+    // tanpa integral image, tanpa pembangunan Entropy dari bawah ke atas, satu thread, gambar RGB
+    SimdLevel bestLevel = detectSimdLevel();
+    setSimdLevel(SIMD_SCALAR);
+    QuadTree tree = buildTopDownTree(referenceImage, minBlockSize, threshold, method, referenceBlockError);
+    ImageView output = createImageView(width, height);
+    drawQuadTree(output, tree);
+    
+    reference.nodeCount = static_cast<int>(tree.nodes.size());
+    reference.maxDepth = getQuadTreeDepth(tree);
+    reference.leafHash = hashQuadTreeLeaves(tree);
+    reference.pixelHash = hashImageView(output);
+    
+    // Untuk setiap tingkat SIMD yang didukung CPU: fungsi error per pixel dengan kernel baris
+    // (dari atas ke bawah), lalu buildQuadTree yang dipakai program (integral image untuk
+    // Variance dan SSIM, Entropy dari bawah ke atas)
+    for (int level = SIMD_SCALAR; level <= bestLevel; level++) {
+        setSimdLevel(static_cast<SimdLevel>(level));
+        std::string name = getSimdLevelName(static_cast<SimdLevel>(level));
+        
+        checkPath((name + "+pixel").c_str(), reference,
+                  buildTopDownTree(image, minBlockSize, threshold, method, pixelBlockError), log, failures);
+        checkPath((name + "+build").c_str(), reference,
+                  buildQuadTree(image, integral, 0, 0, width, height, minBlockSize, threshold, method), log, failures);
+    }
+    
+    // Build paralel dan pemangkasan pohon penuh (jalur target kompresi) dengan SIMD terbaik
+    std::vector<int> threadCounts = {2, 4};
+    if (std::find(threadCounts.begin(), threadCounts.end(), threadCount) == threadCounts.end() && threadCount > 1) {
+        threadCounts.push_back(threadCount);
+    }
+    for (int threads : threadCounts) {
+        std::string name = "parallel-" + std::to_string(threads);
+        checkPath(name.c_str(), reference,
+                  buildQuadTreeParallel(image, integral, 0, 0, width, height, minBlockSize, threshold, method, threads),
+                  log, failures);
+    }
+    
+    FullQuadTree full = buildFullQuadTree(image, integral, minBlockSize, method);
+    checkPath("prune", reference, pruneQuadTree(full, threshold), log, failures);
+    
+    // Penggambaran per region harus sama dengan drawQuadTree
+    ImageView regionOutput = createImageView(width, height);
+    drawQuadTreeRegion(regionOutput, tree, 0, 0, width, height);
+    checkPixels("drawQuadTreeRegion", reference, hashImageView(regionOutput), log, failures);
+    
+    // Format .qtc (pre-order dan progresif): decode harus mengembalikan pohon yang sama dan
+    // render langsung harus menghasilkan pixel yang sama
+    const int orders[2] = {QTC_ORDER_PREORDER, QTC_ORDER_LEVEL};
+    for (int order : orders) {
+        std::vector<BYTE> buffer;
+        bool encoded = order == QTC_ORDER_LEVEL ? encodeQTCProgressive(tree, minBlockSize, buffer)
+                                                : encodeQTC(tree, minBlockSize, buffer);
+        const char* name = order == QTC_ORDER_LEVEL ? "qtc-progresif" : "qtc";
+        
+        QuadTree decoded;
+        if (!encoded || !decodeQTC(buffer.data(), buffer.size(), decoded)) {
+            log << "  BEDA " << name << ": gagal encode/decode" << std::endl;
+            failures++;
+            continue;
+        }
+        
+        checkPath(name, reference, decoded, log, failures);
+        ImageView decodedOutput = createImageView(width, height);
+        drawQuadTree(decodedOutput, decoded);
+        checkPixels((std::string(name) + "+decode").c_str(), reference, hashImageView(decodedOutput), log, failures);
+        checkPixels((std::string(name) + "+render").c_str(), reference, hashRenderedQTC(buffer, width, height), log, failures);
+    }
+    
+    failures += verifyQTCStream(tree, minBlockSize, reference, log);
+    
+    setSimdLevel(bestLevel);
+    return failures;
+}
+
+// Fungsi untuk menyalin gambar grayscale menjadi tiga channel yang sama
+static ImageView expandGrayscale(const ImageView& image) {
+    ImageView color = createImageView(image.width, image.height);
+    for (int c = 0; c < 3; c++) {
+        color.planes[c] = image.planes[0];
+    }
+    return color;
+}
+
+int verifyImage(const std::string& name, const ImageView& image, int threadCount,
+                std::vector<VerifyCase>& cases, std::ostream& log) {
+    IntegralImage integral = buildIntegralImage(image);
+    
+    // Gambar grayscale diverifikasi terhadap referensi dari salinan RGB-nya sehingga jalur
+    // satu channel ikut dibandingkan
+    ImageView colorImage;
+    if (image.isGrayscale()) {
+        colorImage = expandGrayscale(image);
+    }
+    const ImageView& referenceImage = image.isGrayscale() ? colorImage : image;
+    int failures = 0;
+    
+    for (int method = 1; method <= 5; method++) {
+        for (double threshold : VERIFY_THRESHOLDS[method]) {
+            for (int minBlockSize : VERIFY_MIN_BLOCK_SIZES) {
+                VerifyCase reference;
+                reference.image = name;
+                reference.method = method;
+                reference.threshold = threshold;
+                reference.minBlockSize = minBlockSize;
+                
+                std::ostringstream caseLog;
+                int caseFailures = verifyCase(image, referenceImage, integral, threadCount, reference, caseLog);
+                if (caseFailures > 0) {
+                    log << name << " metode " << method << " threshold " << threshold
+                        << " blok minimum " << minBlockSize << ":\n" << caseLog.str();
+                }
+                
+                failures += caseFailures;
+                cases.push_back(reference);
+            }
+        }
+    }
+    
+    return failures;
+}
+
+static bool sameKey(const VerifyCase& a, const VerifyCase& b) {
+    return a.image == b.image && a.method == b.method && a.threshold == b.threshold &&
+           a.minBlockSize == b.minBlockSize;
+}
+
+int compareWithGolden(const std::vector<VerifyCase>& cases, const std::vector<VerifyCase>& golden, std::ostream& log) {
+    int failures = 0;
+    
+    for (const VerifyCase& current : cases) {
+        auto match = std::find_if(golden.begin(), golden.end(),
+                                  [&](const VerifyCase& expected) { return sameKey(current, expected); });
+        if (match == golden.end()) {
+            log << "Tidak ada nilai golden untuk " << current.image << " metode " << current.method
+                << " threshold " << current.threshold << " blok minimum " << current.minBlockSize << std::endl;
+            failures++;
+            continue;
+        }
+        
+        if (match->nodeCount != current.nodeCount || match->maxDepth != current.maxDepth ||
+            match->leafHash != current.leafHash || match->pixelHash != current.pixelHash) {
+            log << "BEDA GOLDEN " << current.image << " metode " << current.method
+                << " threshold " << current.threshold << " blok minimum " << current.minBlockSize
+                << ": " << current.nodeCount << " simpul, kedalaman " << current.maxDepth
+                << " (golden " << match->nodeCount << " simpul, kedalaman " << match->maxDepth << ")" << std::endl;
+            failures++;
+        }
+    }
+    
+    return failures;
+}
+
+// Format baris: gambar metode threshold blokMinimum jumlahSimpul kedalaman hashDaun hashPixel
+bool loadGoldenFile(const std::string& path, std::vector<VerifyCase>& cases) {
+    std::ifstream file(path.c_str());
+    if (!file) return false;
+    
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        
+        char image[1024];
+        uint64_t leafHash, pixelHash;
+        VerifyCase entry;
+        if (sscanf(line.c_str(), "%1023s %d %lf %d %d %d %" SCNx64 " %" SCNx64, image, &entry.method,
+                   &entry.threshold, &entry.minBlockSize, &entry.nodeCount, &entry.maxDepth,
+                   &leafHash, &pixelHash) != 8) {
+            return false;
+        }
+        entry.image = image;
+        entry.leafHash = leafHash;
+        entry.pixelHash = pixelHash;
+        cases.push_back(entry);
+    }
+    return true;
+}
+
+bool saveGoldenFile(const std::string& path, const std::vector<VerifyCase>& cases) {
+    std::ofstream file(path.c_str());
+    if (!file) return false;
+    
+    file << "# gambar metode threshold blok_minimum simpul kedalaman hash_daun hash_pixel\n";
+    for (const VerifyCase& entry : cases) {
+        char hashes[48];
+        snprintf(hashes, sizeof(hashes), "%016llx %016llx", entry.leafHash, entry.pixelHash);
+        file << entry.image << " " << entry.method << " " << entry.threshold << " " << entry.minBlockSize
+             << " " << entry.nodeCount << " " << entry.maxDepth << " " << hashes << "\n";
+    }
+    return static_cast<bool>(file);
+}
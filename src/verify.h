@@ -0,0 +1,43 @@
+#ifndef VERIFY_H
+#define VERIFY_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "quadtree.h"
+
+// Hasil referensi satu kombinasi gambar, metode, threshold dan ukuran blok minimum.
+// Satu baris file golden berisi field ini dengan urutan yang sama.
+struct VerifyCase {
+    std::string image;              // Nama file gambar tanpa direktori
+    int method;
+    double threshold;
+    int minBlockSize;
+    int nodeCount;
+    int maxDepth;
+    unsigned long long leafHash;    // Posisi, ukuran dan warna semua daun
+    unsigned long long pixelHash;   // Pixel hasil drawQuadTree
+};
+
+// Fungsi untuk menghitung hash FNV-1a dari daun pohon dan dari pixel gambar
+unsigned long long hashQuadTreeLeaves(const QuadTree& tree);
+unsigned long long hashImageView(const ImageView& image);
+
+// Fungsi untuk memverifikasi satu gambar: pohon referensi dibangun dari atas ke bawah dengan
+// statistik blok dari scan pixel skalar dan satu thread, lalu setiap jalur yang dipercepat
+// (fungsi error per pixel dengan kernel SIMD, integral image, Entropy dari bawah ke atas, build
+// paralel, pemangkasan pohon penuh, drawQuadTreeRegion, format .qtc, stream progresif per
+// potongan) dibandingkan dengannya. Hasil referensi ditambahkan ke cases. Mengembalikan
+// jumlah jalur yang berbeda dari referensi.
+int verifyImage(const std::string& name, const ImageView& image, int threadCount,
+                std::vector<VerifyCase>& cases, std::ostream& log);
+
+// Fungsi untuk membandingkan hasil referensi dengan nilai golden. Kasus yang tidak ada di file
+// golden juga dihitung sebagai perbedaan. Mengembalikan jumlah perbedaan.
+int compareWithGolden(const std::vector<VerifyCase>& cases, const std::vector<VerifyCase>& golden, std::ostream& log);
+
+// Fungsi untuk membaca dan menulis file golden (teks, satu kasus per baris)
+bool loadGoldenFile(const std::string& path, std::vector<VerifyCase>& cases);
+bool saveGoldenFile(const std::string& path, const std::vector<VerifyCase>& cases);
+
+#endif